@@ -12,6 +12,16 @@ namespace libff {
 bigint<alt_bn128_r_limbs> alt_bn128_modulus_r;
 bigint<alt_bn128_q_limbs> alt_bn128_modulus_q;
 
+#if GMP_NUMB_BITS == 64
+/* out-of-line definitions of the Fp_params constants, for when they are odr-used */
+constexpr bool Fp_params<alt_bn128_r_limbs, alt_bn128_modulus_r>::is_constexpr;
+constexpr mp_limb_t Fp_params<alt_bn128_r_limbs, alt_bn128_modulus_r>::modulus[];
+constexpr mp_limb_t Fp_params<alt_bn128_r_limbs, alt_bn128_modulus_r>::inv;
+constexpr bool Fp_params<alt_bn128_q_limbs, alt_bn128_modulus_q>::is_constexpr;
+constexpr mp_limb_t Fp_params<alt_bn128_q_limbs, alt_bn128_modulus_q>::modulus[];
+constexpr mp_limb_t Fp_params<alt_bn128_q_limbs, alt_bn128_modulus_q>::inv;
+#endif
+
 void init_alt_bn128_fields()
 {
     using bigint_r = bigint<alt_bn128_r_limbs>;
@@ -23,6 +23,32 @@ const mp_size_t alt_bn128_q_limbs = (alt_bn128_q_bitcount+GMP_NUMB_BITS-1)/GMP_N
 extern bigint<alt_bn128_r_limbs> alt_bn128_modulus_r;
 extern bigint<alt_bn128_q_limbs> alt_bn128_modulus_q;
 
+#if GMP_NUMB_BITS == 64
+/* compile-time copies of the field parameters set in init_alt_bn128_fields(), see Fp_params */
+template<>
+struct Fp_params<alt_bn128_r_limbs, alt_bn128_modulus_r> {
+    static constexpr bool is_constexpr = true;
+    static constexpr mp_limb_t modulus[4] = {
+        0x43e1f593f0000001UL, 0x2833e84879b97091UL, 0xb85045b68181585dUL, 0x30644e72e131a029UL };
+    static constexpr mp_limb_t inv = 0xc2e1f593efffffffUL;
+};
+
+template<>
+struct Fp_params<alt_bn128_q_limbs, alt_bn128_modulus_q> {
+    static constexpr bool is_constexpr = true;
+    static constexpr mp_limb_t modulus[4] = {
+        0x3c208c16d87cfd47UL, 0x97816a916871ca8dUL, 0xb85045b68181585dUL, 0x30644e72e131a029UL };
+    static constexpr mp_limb_t inv = 0x87d20782e4866389UL;
+};
+#endif
+
+/* Fq2 = Fq[U]/(U^2+1), see Fp2_non_residue_is_minus_one */
+template<>
+struct Fp2_non_residue_is_minus_one<alt_bn128_q_limbs, alt_bn128_modulus_q> : std::true_type {};
+/* Fq6 = Fq2[V]/(V^3-(9+U)), see Fp6_3over2_non_residue_c0 */
+template<>
+struct Fp6_3over2_non_residue_c0<alt_bn128_q_limbs, alt_bn128_modulus_q> : std::integral_constant<unsigned, 9> {};
+
 typedef Fp_model<alt_bn128_r_limbs, alt_bn128_modulus_r> alt_bn128_Fr;
 typedef Fp_model<alt_bn128_q_limbs, alt_bn128_modulus_q> alt_bn128_Fq;
 typedef Fp2_model<alt_bn128_q_limbs, alt_bn128_modulus_q> alt_bn128_Fq2;
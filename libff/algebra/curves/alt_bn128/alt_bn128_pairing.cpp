@@ -393,14 +393,17 @@ alt_bn128_Fq12 alt_bn128_ate_miller_loop(const alt_bn128_ate_G1_precomp &prec_P,
 
         c = prec_Q.coeffs[idx++];
         f = f.squared();
-        f = f.mul_by_024(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
 
         if (bit)
         {
-            c = prec_Q.coeffs[idx++];
+            const alt_bn128_ate_ell_coeffs c_add = prec_Q.coeffs[idx++];
+            f = f.mul_by_01234(alt_bn128_Fq12::mul_024_by_024(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV,
+                                                             c_add.ell_0, prec_P.PY * c_add.ell_VW, prec_P.PX * c_add.ell_VV));
+        }
+        else
+        {
             f = f.mul_by_024(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
         }
-
     }
 
     if (alt_bn128_ate_is_loop_count_neg)
@@ -408,11 +411,10 @@ alt_bn128_Fq12 alt_bn128_ate_miller_loop(const alt_bn128_ate_G1_precomp &prec_P,
     	f = f.inverse();
     }
 
-    c = prec_Q.coeffs[idx++];
-    f = f.mul_by_024(c.ell_0,prec_P.PY * c.ell_VW,prec_P.PX * c.ell_VV);
-
-    c = prec_Q.coeffs[idx++];
-    f = f.mul_by_024(c.ell_0,prec_P.PY * c.ell_VW,prec_P.PX * c.ell_VV);
+    const alt_bn128_ate_ell_coeffs c1 = prec_Q.coeffs[idx++];
+    const alt_bn128_ate_ell_coeffs c2 = prec_Q.coeffs[idx++];
+    f = f.mul_by_01234(alt_bn128_Fq12::mul_024_by_024(c1.ell_0, prec_P.PY * c1.ell_VW, prec_P.PX * c1.ell_VV,
+                                                     c2.ell_0, prec_P.PY * c2.ell_VW, prec_P.PX * c2.ell_VV));
 
     leave_block("Call to alt_bn128_ate_miller_loop");
     return f;
@@ -451,8 +453,8 @@ alt_bn128_Fq12 alt_bn128_ate_double_miller_loop(const alt_bn128_ate_G1_precomp &
 
         f = f.squared();
 
-        f = f.mul_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-        f = f.mul_by_024(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+        f = f.mul_by_01234(alt_bn128_Fq12::mul_024_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV,
+                                                         c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV));
 
         if (bit)
         {
@@ -460,8 +462,8 @@ alt_bn128_Fq12 alt_bn128_ate_double_miller_loop(const alt_bn128_ate_G1_precomp &
             alt_bn128_ate_ell_coeffs c2 = prec_Q2.coeffs[idx];
             ++idx;
 
-            f = f.mul_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-            f = f.mul_by_024(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+            f = f.mul_by_01234(alt_bn128_Fq12::mul_024_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV,
+                                                             c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV));
         }
     }
 
@@ -473,14 +475,14 @@ alt_bn128_Fq12 alt_bn128_ate_double_miller_loop(const alt_bn128_ate_G1_precomp &
     alt_bn128_ate_ell_coeffs c1 = prec_Q1.coeffs[idx];
     alt_bn128_ate_ell_coeffs c2 = prec_Q2.coeffs[idx];
     ++idx;
-    f = f.mul_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-    f = f.mul_by_024(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+    f = f.mul_by_01234(alt_bn128_Fq12::mul_024_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV,
+                                                     c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV));
 
     c1 = prec_Q1.coeffs[idx];
     c2 = prec_Q2.coeffs[idx];
     ++idx;
-    f = f.mul_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-    f = f.mul_by_024(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+    f = f.mul_by_01234(alt_bn128_Fq12::mul_024_by_024(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV,
+                                                     c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV));
 
     leave_block("Call to alt_bn128_ate_double_miller_loop");
 
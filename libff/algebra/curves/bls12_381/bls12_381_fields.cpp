@@ -12,6 +12,16 @@ namespace libff {
 bigint<bls12_381_r_limbs> bls12_381_modulus_r;
 bigint<bls12_381_q_limbs> bls12_381_modulus_q;
 
+#if GMP_NUMB_BITS == 64
+/* out-of-line definitions of the Fp_params constants, for when they are odr-used */
+constexpr bool Fp_params<bls12_381_r_limbs, bls12_381_modulus_r>::is_constexpr;
+constexpr mp_limb_t Fp_params<bls12_381_r_limbs, bls12_381_modulus_r>::modulus[];
+constexpr mp_limb_t Fp_params<bls12_381_r_limbs, bls12_381_modulus_r>::inv;
+constexpr bool Fp_params<bls12_381_q_limbs, bls12_381_modulus_q>::is_constexpr;
+constexpr mp_limb_t Fp_params<bls12_381_q_limbs, bls12_381_modulus_q>::modulus[];
+constexpr mp_limb_t Fp_params<bls12_381_q_limbs, bls12_381_modulus_q>::inv;
+#endif
+
 void init_bls12_381_fields()
 {
     using bigint_r = bigint<bls12_381_r_limbs>;
@@ -23,6 +23,33 @@ const mp_size_t bls12_381_q_limbs = (bls12_381_q_bitcount+GMP_NUMB_BITS-1)/GMP_N
 extern bigint<bls12_381_r_limbs> bls12_381_modulus_r;
 extern bigint<bls12_381_q_limbs> bls12_381_modulus_q;
 
+#if GMP_NUMB_BITS == 64
+/* compile-time copies of the field parameters set in init_bls12_381_fields(), see Fp_params */
+template<>
+struct Fp_params<bls12_381_r_limbs, bls12_381_modulus_r> {
+    static constexpr bool is_constexpr = true;
+    static constexpr mp_limb_t modulus[4] = {
+        0xffffffff00000001UL, 0x53bda402fffe5bfeUL, 0x3339d80809a1d805UL, 0x73eda753299d7d48UL };
+    static constexpr mp_limb_t inv = 0xfffffffeffffffffUL;
+};
+
+template<>
+struct Fp_params<bls12_381_q_limbs, bls12_381_modulus_q> {
+    static constexpr bool is_constexpr = true;
+    static constexpr mp_limb_t modulus[6] = {
+        0xb9feffffffffaaabUL, 0x1eabfffeb153ffffUL, 0x6730d2a0f6b0f624UL, 0x64774b84f38512bfUL,
+        0x4b1ba7b6434bacd7UL, 0x1a0111ea397fe69aUL };
+    static constexpr mp_limb_t inv = 0x89f3fffcfffcfffdUL;
+};
+#endif
+
+/* Fq2 = Fq[U]/(U^2+1), see Fp2_non_residue_is_minus_one */
+template<>
+struct Fp2_non_residue_is_minus_one<bls12_381_q_limbs, bls12_381_modulus_q> : std::true_type {};
+/* Fq6 = Fq2[V]/(V^3-(1+U)), see Fp6_3over2_non_residue_c0 */
+template<>
+struct Fp6_3over2_non_residue_c0<bls12_381_q_limbs, bls12_381_modulus_q> : std::integral_constant<unsigned, 1> {};
+
 typedef Fp_model<bls12_381_r_limbs, bls12_381_modulus_r> bls12_381_Fr;
 typedef Fp_model<bls12_381_q_limbs, bls12_381_modulus_q> bls12_381_Fq;
 typedef Fp2_model<bls12_381_q_limbs, bls12_381_modulus_q> bls12_381_Fq2;
@@ -339,14 +339,17 @@ bls12_381_Fq12 bls12_381_ate_miller_loop(const bls12_381_ate_G1_precomp &prec_P,
 
         c = prec_Q.coeffs[idx++];
         f = f.squared();
-        f = f.mul_by_045(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
 
         if (bit)
         {
-            c = prec_Q.coeffs[idx++];
+            const bls12_381_ate_ell_coeffs c_add = prec_Q.coeffs[idx++];
+            f = f.mul_by_01245(bls12_381_Fq12::mul_045_by_045(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV,
+                                                             c_add.ell_0, prec_P.PY * c_add.ell_VW, prec_P.PX * c_add.ell_VV));
+        }
+        else
+        {
             f = f.mul_by_045(c.ell_0, prec_P.PY * c.ell_VW, prec_P.PX * c.ell_VV);
         }
-
     }
 
     if (bls12_381_ate_is_loop_count_neg)
@@ -391,8 +394,8 @@ bls12_381_Fq12 bls12_381_ate_double_miller_loop(const bls12_381_ate_G1_precomp &
 
         f = f.squared();
 
-        f = f.mul_by_045(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-        f = f.mul_by_045(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+        f = f.mul_by_01245(bls12_381_Fq12::mul_045_by_045(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV,
+                                                         c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV));
 
         if (bit)
         {
@@ -400,8 +403,8 @@ bls12_381_Fq12 bls12_381_ate_double_miller_loop(const bls12_381_ate_G1_precomp &
             bls12_381_ate_ell_coeffs c2 = prec_Q2.coeffs[idx];
             ++idx;
 
-            f = f.mul_by_045(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV);
-            f = f.mul_by_045(c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV);
+            f = f.mul_by_01245(bls12_381_Fq12::mul_045_by_045(c1.ell_0, prec_P1.PY * c1.ell_VW, prec_P1.PX * c1.ell_VV,
+                                                             c2.ell_0, prec_P2.PY * c2.ell_VW, prec_P2.PX * c2.ell_VV));
         }
     }
 
@@ -1,7 +1,8 @@
 /** @file
  *****************************************************************************
- Declaration of interfaces for (square-and-multiply) exponentiation and
- Tonelli-Shanks square root.
+ Declaration of interfaces for (sliding-window) exponentiation,
+ fixed-exponent addition chains, Tonelli-Shanks and table-based square
+ roots, constant-time modular inversion and the Jacobi symbol.
  *****************************************************************************
  * @author     This file is part of libff, developed by SCIPR Lab
  *             and contributors (see AUTHORS).
@@ -12,19 +13,95 @@
 #define ALGORITHMS_HPP_
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "libff/algebra/field_utils/bigint.hpp"
 
 namespace libff {
 
-/** Repeated squaring. */
+/**
+ * Estimated number of multiplications of a sliding-window exponentiation
+ * with window w by an exponent of the given bit length: 2^(w-1) for the
+ * table of odd powers and one per window, of which there are about
+ * bits/(w+1) (bits/2 for w = 1, which needs no table).
+ */
+inline std::size_t sliding_window_cost(const std::size_t bits, const std::size_t w);
+
+/** The window size in 1..8 that minimizes sliding_window_cost. */
+inline std::size_t sliding_window_size(const std::size_t bits);
+
+/**
+ * Sliding-window recoding of exponent: scanning from the top, the exponent
+ * is cut into windows of at most w bits that start and end with a 1 bit.
+ * The value of each window, an odd digit below 2^w, is stored at the index
+ * of its lowest bit and all other digits are 0, so that
+ * exponent = \sum_i digits[i] 2^i and digits.size() == exponent.num_bits().
+ */
+template<mp_size_t m>
+std::vector<long> find_sliding_window(const std::size_t w, const bigint<m> &exponent);
+
+/**
+ * Sliding-window exponentiation over a table of odd powers of the base, with
+ * the window size picked from the bit length of the exponent. Squarings use
+ * FieldT::squared() when FieldT has it.
+ */
 template<typename FieldT, mp_size_t m>
 FieldT power(const FieldT &base, const bigint<m> &exponent);
 
-/** Repeated squaring. */
+/** As above. */
 template<typename FieldT>
 FieldT power(const FieldT &base, const unsigned long exponent);
 
+/**
+ * Exponentiation of an element of the cyclotomic subgroup of FieldT (as for
+ * GT in Fp4, Fp6_2over3 and Fp12_2over3over2), where unitary_inverse() is a
+ * cheap inverse. The exponent is recoded in wNAF, so negative digits use the
+ * inverted table, and squarings use cyclotomic_squared(). The window size
+ * is picked per exponent, so sparse exponents get few multiplications.
+ */
+template<typename FieldT, mp_size_t m>
+FieldT cyclotomic_power(const FieldT &base, const bigint<m> &exponent);
+
+/**
+ * Precomputed addition chain for a fixed exponent, for exponents that are
+ * used over and over, like (p+1)/4, (p-1)/2, p-2 or (t-1)/2.
+ *
+ * The chain is a sliding-window decomposition of the exponent over a table
+ * of odd powers of the base. The window size is picked at construction to
+ * minimize the total number of multiplications and squarings, so building
+ * the chain once and evaluating it many times saves both the bit scanning
+ * and the extra multiplications of plain square-and-multiply.
+ */
+class addition_chain {
+public:
+    template<mp_size_t m>
+    explicit addition_chain(const bigint<m> &exponent);
+
+    /** Returns base^exponent. */
+    template<typename FieldT>
+    FieldT evaluate(const FieldT &base) const;
+
+    std::size_t window_size() const { return window; }
+    /** Number of multiplications and squarings evaluate() performs. */
+    std::size_t num_operations() const { return operations; }
+
+private:
+    struct step {
+        std::size_t squarings; // squarings before the multiplication
+        std::size_t table_index; // multiply by base^(2*table_index+1)
+    };
+
+    std::size_t window;
+    std::size_t operations;
+    std::size_t table_size;
+    std::size_t final_squarings;
+    std::vector<step> steps;
+
+    template<mp_size_t m>
+    std::size_t build(const bigint<m> &exponent, const std::size_t w);
+};
+
 /**
  * Tonelli-Shanks square root with given s, t, and quadratic non-residue.
  * Only terminates if there is a square root. Only works if required parameters
@@ -33,6 +110,71 @@ FieldT power(const FieldT &base, const unsigned long exponent);
 template<typename FieldT>
 FieldT tonelli_shanks_sqrt(const FieldT &value);
 
+/**
+ * As above, with w = value^((t-1)/2) already computed by the caller.
+ */
+template<typename FieldT>
+FieldT tonelli_shanks_sqrt(const FieldT &value, const FieldT &w);
+
+/**
+ * Square root for prime fields with a large 2-adicity s, following Sarkar
+ * <https://eprint.iacr.org/2020/1407>.
+ *
+ * Like Tonelli-Shanks, this reduces to finding the discrete logarithm of
+ * b = value^t in the subgroup of order 2^s generated by nqr_to_t. Instead of
+ * finding it one bit at a time, which costs O(s^2) squarings, the logarithm
+ * is read off w bits at a time from precomputed tables of powers of
+ * nqr_to_t, for s squarings and O((s/w)^2) multiplications in total.
+ *
+ * The tables are built from FieldT::s, t and nqr_to_t, so the field must be
+ * initialized before construction. Lookups use the low limb of
+ * canonical_mont_repr(), so FieldT must be an Fp_model.
+ */
+template<typename FieldT>
+class sqrt_table {
+public:
+    sqrt_table();
+
+    /** Returns a square root of value, which HAS TO BE A SQUARE. */
+    FieldT sqrt(const FieldT &value) const;
+
+    std::size_t window_size() const { return window; }
+
+private:
+    std::size_t window;
+    std::size_t num_digits;
+    addition_chain t_minus_1_over_2_chain;
+    /* powers[k][d] = nqr_to_t^(-d * 2^k); only filled for the k that are used */
+    std::vector<std::vector<FieldT> > powers;
+    /* (low limb of zeta^j, j) sorted by limb, where zeta = nqr_to_t^(2^(s-window)) */
+    std::vector<std::pair<mp_limb_t, std::size_t> > roots_of_unity;
+
+    std::size_t digit_offset(const std::size_t i) const { return i * window; }
+    std::size_t digit_width(const std::size_t i) const;
+    std::size_t lookup(const FieldT &zeta_power) const;
+    void fill_powers(const std::size_t k);
+};
+
+/**
+ * Modular inverse of a (0 < a < modulus) for an odd modulus of modulus_bits
+ * bits, by the Bernstein-Yang "safegcd" divstep algorithm
+ * <https://eprint.iacr.org/2019/266>, in the batched, radix-2^60 form of
+ * Pornin / libsecp256k1. The sequence of operations only depends on
+ * modulus_bits, not on a, and no memory is allocated.
+ */
+template<mp_size_t n>
+bigint<n> safegcd_inverse(const bigint<n> &a, const bigint<n> &modulus, const size_t modulus_bits);
+
+/**
+ * Jacobi symbol (a | modulus) for an odd modulus and 0 <= a < modulus, by a
+ * variable-time binary GCD: the posdivsteps variant of safegcd, which keeps
+ * track of the symbol as it goes (as in libsecp256k1). For a prime modulus
+ * this is the Legendre symbol. Should the steps fail to converge in the
+ * expected number of iterations, mpz_jacobi is used instead.
+ */
+template<mp_size_t n>
+int jacobi_symbol(const bigint<n> &a, const bigint<n> &modulus);
+
 } // namespace libff
 
 #include <libff/algebra/field_utils/algorithms.tcc>
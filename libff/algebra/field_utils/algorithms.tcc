@@ -1,7 +1,8 @@
 /** @file
  *****************************************************************************
- Declaration of interfaces for (square-and-multiply) exponentiation and
- Tonelli-Shanks square root.
+ Implementation of interfaces for (sliding-window) exponentiation,
+ fixed-exponent addition chains, Tonelli-Shanks and table-based square
+ roots, constant-time modular inversion and the Jacobi symbol.
  *****************************************************************************
  * @author     This file is part of libff, developed by SCIPR Lab
  *             and contributors (see AUTHORS).
@@ -11,6 +12,10 @@
 #ifndef ALGORITHMS_TCC_
 #define ALGORITHMS_TCC_
 
+#include <algorithm>
+#include <cassert>
+
+#include "libff/algebra/scalar_multiplication/wnaf.hpp"
 #include "libff/common/utils.hpp"
 #include "libff/common/profiling.hpp"
 
@@ -18,23 +23,118 @@ namespace libff {
 
 using std::size_t;
 
+/*
+  Helpers for power and cyclotomic_power.
+ */
+namespace exponentiation {
+
+/* x.squared() where FieldT has it, x * x otherwise (e.g. bn128_GT) */
+template<typename FieldT>
+auto squared(const FieldT &x, int) -> decltype(x.squared())
+{
+    return x.squared();
+}
+
+template<typename FieldT>
+FieldT squared(const FieldT &x, long)
+{
+    return x * x;
+}
+
+/* number of multiplications of a wNAF exponentiation with this window, table included */
+inline size_t wnaf_cost(const std::vector<long> &naf, const size_t w)
+{
+    size_t cost = (w > 1 ? (1ul << (w-1)) : 0);
+    for (size_t i = 0; i < naf.size(); ++i)
+    {
+        cost += (naf[i] != 0 ? 1 : 0);
+    }
+    return cost;
+}
+
+} // namespace exponentiation
+
+inline size_t sliding_window_cost(const size_t bits, const size_t w)
+{
+    return (w > 1 ? (1ul << (w-1)) + bits / (w+1) : bits / 2);
+}
+
+inline size_t sliding_window_size(const size_t bits)
+{
+    size_t best_window = 1;
+    for (size_t w = 2; w <= 8; ++w)
+    {
+        if (sliding_window_cost(bits, w) < sliding_window_cost(bits, best_window))
+        {
+            best_window = w;
+        }
+    }
+    return best_window;
+}
+
+template<mp_size_t m>
+std::vector<long> find_sliding_window(const size_t w, const bigint<m> &exponent)
+{
+    std::vector<long> digits(exponent.num_bits(), 0);
+    for (long i = static_cast<long>(digits.size()) - 1; i >= 0; )
+    {
+        if (!exponent.test_bit(i))
+        {
+            --i;
+            continue;
+        }
+
+        long j = std::max(i - static_cast<long>(w) + 1, 0l);
+        while (!exponent.test_bit(j))
+        {
+            ++j;
+        }
+
+        long digit = 0;
+        for (long k = i; k >= j; --k)
+        {
+            digit = 2 * digit + (exponent.test_bit(k) ? 1 : 0);
+        }
+        digits[j] = digit;
+        i = j - 1;
+    }
+    return digits;
+}
+
 template<typename FieldT, mp_size_t m>
 FieldT power(const FieldT &base, const bigint<m> &exponent)
 {
+    const long bits = exponent.num_bits();
+    if (bits == 0)
+    {
+        return FieldT::one();
+    }
+    const size_t w = sliding_window_size(bits);
+
+    /* table[k] = base^(2k+1) */
+    std::vector<FieldT> table(w > 1 ? 1ul << (w-1) : 1, base);
+    if (table.size() > 1)
+    {
+        const FieldT base_squared = exponentiation::squared(base, 0);
+        for (size_t k = 1; k < table.size(); ++k)
+        {
+            table[k] = table[k-1] * base_squared;
+        }
+    }
+
+    const std::vector<long> digits = find_sliding_window(w, exponent);
     FieldT result = FieldT::one();
     bool found_one = false;
-
-    for (long i = exponent.max_bits() - 1; i >= 0; --i)
+    for (long i = bits - 1; i >= 0; --i)
     {
         if (found_one)
         {
-            result = result * result;
+            result = exponentiation::squared(result, 0);
         }
-
-        if (exponent.test_bit(i))
+        if (digits[i] != 0)
         {
+            result = (found_one ? result * table[digits[i]/2] : table[digits[i]/2]);
             found_one = true;
-            result = result * base;
         }
     }
 
@@ -47,8 +147,156 @@ FieldT power(const FieldT &base, const unsigned long exponent)
     return power<FieldT>(base, bigint<1>(exponent));
 }
 
+template<typename FieldT, mp_size_t m>
+FieldT cyclotomic_power(const FieldT &base, const bigint<m> &exponent)
+{
+    /* the exponents met in final exponentiations are often sparse, so count the multiplications for each window */
+    size_t best_window = 1;
+    std::vector<long> naf = find_wnaf(1, exponent);
+    size_t best_cost = exponentiation::wnaf_cost(naf, 1);
+    for (size_t w = 2; w <= 6; ++w)
+    {
+        std::vector<long> candidate = find_wnaf(w, exponent);
+        const size_t cost = exponentiation::wnaf_cost(candidate, w);
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            best_window = w;
+            naf.swap(candidate);
+        }
+    }
+
+    /* table[k] = base^(2k+1), inverse_table[k] = base^-(2k+1) */
+    std::vector<FieldT> table(1ul << (best_window-1), base);
+    if (table.size() > 1)
+    {
+        const FieldT base_squared = base.cyclotomic_squared();
+        for (size_t k = 1; k < table.size(); ++k)
+        {
+            table[k] = table[k-1] * base_squared;
+        }
+    }
+    std::vector<FieldT> inverse_table(table.size());
+    for (size_t k = 0; k < table.size(); ++k)
+    {
+        inverse_table[k] = table[k].unitary_inverse();
+    }
+
+    FieldT result = FieldT::one();
+    bool found_nonzero = false;
+    for (long i = naf.size() - 1; i >= 0; --i)
+    {
+        if (found_nonzero)
+        {
+            result = result.cyclotomic_squared();
+        }
+
+        if (naf[i] != 0)
+        {
+            const FieldT &factor = (naf[i] > 0 ? table[naf[i]/2] : inverse_table[(-naf[i])/2]);
+            result = (found_nonzero ? result * factor : factor);
+            found_nonzero = true;
+        }
+    }
+
+    return result;
+}
+
+template<mp_size_t m>
+addition_chain::addition_chain(const bigint<m> &exponent)
+{
+    size_t best_window = 1;
+    size_t best_cost = build(exponent, 1);
+    for (size_t w = 2; w <= 8; ++w)
+    {
+        const size_t cost = build(exponent, w);
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            best_window = w;
+        }
+    }
+    build(exponent, best_window);
+}
+
+template<mp_size_t m>
+size_t addition_chain::build(const bigint<m> &exponent, const size_t w)
+{
+    window = w;
+    table_size = 1;
+    steps.clear();
+
+    /* each step squares from the lowest bit of the previous window down to its own */
+    const std::vector<long> digits = find_sliding_window(w, exponent);
+    long previous = -1;
+    for (long i = static_cast<long>(digits.size()) - 1; i >= 0; --i)
+    {
+        if (digits[i] != 0)
+        {
+            const size_t index = digits[i] / 2;
+            steps.push_back({steps.empty() ? 0 : static_cast<size_t>(previous - i), index});
+            table_size = std::max(table_size, index + 1);
+            previous = i;
+        }
+    }
+    final_squarings = (previous > 0 ? previous : 0);
+
+    /* one squaring and table_size-1 multiplications for the table, then the steps */
+    operations = (table_size > 1 ? table_size : 0) + final_squarings;
+    for (size_t k = 0; k < steps.size(); ++k)
+    {
+        operations += steps[k].squarings + (k > 0 ? 1 : 0);
+    }
+    return operations;
+}
+
+template<typename FieldT>
+FieldT addition_chain::evaluate(const FieldT &base) const
+{
+    if (steps.empty())
+    {
+        return FieldT::one();
+    }
+
+    /* table[k] = base^(2k+1) */
+    std::vector<FieldT> table(table_size, base);
+    if (table_size > 1)
+    {
+        const FieldT base_squared = base.squared();
+        for (size_t k = 1; k < table_size; ++k)
+        {
+            table[k] = table[k-1] * base_squared;
+        }
+    }
+
+    FieldT result = table[steps[0].table_index];
+    for (size_t k = 1; k < steps.size(); ++k)
+    {
+        for (size_t i = 0; i < steps[k].squarings; ++i)
+        {
+            result.square();
+        }
+        result *= table[steps[k].table_index];
+    }
+    for (size_t i = 0; i < final_squarings; ++i)
+    {
+        result.square();
+    }
+
+    return result;
+}
+
 template<typename FieldT>
 FieldT tonelli_shanks_sqrt(const FieldT &value)
+{
+    assert(FieldT::s != 0); // the field must be initialized before the chain is cached
+    /* (t-1)/2 is fixed per field, so its chain is built once */
+    static const addition_chain t_minus_1_over_2_chain(FieldT::t_minus_1_over_2);
+    return tonelli_shanks_sqrt(value, t_minus_1_over_2_chain.evaluate(value));
+}
+
+template<typename FieldT>
+FieldT tonelli_shanks_sqrt(const FieldT &value, const FieldT &w_in)
 {
     // A few assertions to make sure s, t, and nqr are initialized.
     assert(FieldT::s != 0);
@@ -64,7 +312,7 @@ FieldT tonelli_shanks_sqrt(const FieldT &value)
 
     size_t v = FieldT::s;
     FieldT z = FieldT::nqr_to_t;
-    FieldT w = value^FieldT::t_minus_1_over_2;
+    FieldT w = w_in;
     FieldT x = value * w;
     FieldT b = x * w; // b = value^t
 
@@ -109,6 +357,512 @@ FieldT tonelli_shanks_sqrt(const FieldT &value)
     return x;
 }
 
+template<typename FieldT>
+sqrt_table<FieldT>::sqrt_table() :
+    t_minus_1_over_2_chain(FieldT::t_minus_1_over_2)
+{
+    const size_t s = FieldT::s;
+    assert(s != 0 && s < 64); // digits of the logarithm are assembled in a word
+    assert(!FieldT::nqr_to_t.is_zero());
+
+    /* split the s-bit logarithm into num_digits windows of at most 8 bits */
+    num_digits = (s + 7) / 8;
+    window = (s + num_digits - 1) / num_digits;
+
+    /*
+      Digit i is found from b^(2^(s - o_i - w_i)) after dividing out the
+      lower digits j < i, which takes nqr_to_t^(-d * 2^(s - o_i - w_i + o_j)),
+      and the root is assembled from window-sized digits of the halved
+      logarithm, which takes nqr_to_t^(-d * 2^(i * window)).
+    */
+    powers.resize(s);
+    for (size_t i = 0; i < num_digits; ++i)
+    {
+        const size_t shift = s - digit_offset(i) - digit_width(i);
+        for (size_t j = 0; j < i; ++j)
+        {
+            fill_powers(shift + digit_offset(j));
+        }
+        fill_powers(digit_offset(i));
+    }
+
+    /* powers[s - window][(2^window - j) mod 2^window] = zeta^j */
+    const size_t mask = (1ul << window) - 1;
+    fill_powers(s - window);
+    roots_of_unity.reserve(1ul << window);
+    for (size_t j = 0; j < (1ul << window); ++j)
+    {
+        roots_of_unity.emplace_back(powers[s - window][(-j) & mask].canonical_mont_repr().data[0], j);
+    }
+    std::sort(roots_of_unity.begin(), roots_of_unity.end());
+}
+
+template<typename FieldT>
+size_t sqrt_table<FieldT>::digit_width(const size_t i) const
+{
+    return std::min(window, FieldT::s - digit_offset(i));
+}
+
+template<typename FieldT>
+void sqrt_table<FieldT>::fill_powers(const size_t k)
+{
+    if (!powers[k].empty())
+    {
+        return;
+    }
+
+    FieldT base = FieldT::nqr_to_t.inverse();
+    for (size_t i = 0; i < k; ++i)
+    {
+        base.square();
+    }
+
+    powers[k].resize(1ul << window);
+    powers[k][0] = FieldT::one();
+    for (size_t d = 1; d < (1ul << window); ++d)
+    {
+        powers[k][d] = powers[k][d-1] * base;
+    }
+}
+
+template<typename FieldT>
+size_t sqrt_table<FieldT>::lookup(const FieldT &zeta_power) const
+{
+    const mp_limb_t key = zeta_power.canonical_mont_repr().data[0];
+    auto it = std::lower_bound(roots_of_unity.begin(), roots_of_unity.end(),
+                               std::make_pair(key, (size_t)0));
+    /* the low limbs of distinct roots can collide, so compare the whole element */
+    for (; it != roots_of_unity.end() && it->first == key; ++it)
+    {
+        const size_t j = it->second;
+        if (zeta_power == powers[FieldT::s - window][(-j) & ((1ul << window) - 1)])
+        {
+            return j;
+        }
+    }
+
+    assert(0); // not a 2^window-th root of unity
+    return 0;
+}
+
+template<typename FieldT>
+FieldT sqrt_table<FieldT>::sqrt(const FieldT &value) const
+{
+    if (value.is_zero())
+    {
+        return FieldT::zero();
+    }
+
+    const size_t s = FieldT::s;
+    const FieldT w = t_minus_1_over_2_chain.evaluate(value);
+    const FieldT v = value * w; // value^((t+1)/2)
+    FieldT b = v * w; // value^t = nqr_to_t^e for an even e
+
+    /* b_powers[i] = b^(2^(s - o_i - w_i)); the exponents shrink with i */
+    std::vector<FieldT> b_powers(num_digits);
+    size_t squarings = 0;
+    for (size_t i = num_digits; i-- > 0; )
+    {
+        const size_t shift = s - digit_offset(i) - digit_width(i);
+        for (; squarings < shift; ++squarings)
+        {
+            b.square();
+        }
+        b_powers[i] = b;
+    }
+
+    uint64_t e = 0;
+    std::vector<size_t> digits(num_digits);
+    for (size_t i = 0; i < num_digits; ++i)
+    {
+        const size_t shift = s - digit_offset(i) - digit_width(i);
+        FieldT c = b_powers[i];
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (digits[j] != 0)
+            {
+                c *= powers[shift + digit_offset(j)][digits[j]];
+            }
+        }
+
+        /* c = zeta^(d_i * 2^(window - w_i)) */
+        digits[i] = lookup(c) >> (window - digit_width(i));
+        e |= ((uint64_t)digits[i]) << digit_offset(i);
+    }
+    assert((e & 1) == 0); // value is not a square
+
+    /* (v * nqr_to_t^(-e/2))^2 = value^(t+1) * nqr_to_t^(-e) = value */
+    const uint64_t half_e = e >> 1;
+    const uint64_t mask = (1ul << window) - 1;
+    FieldT result = v;
+    for (size_t i = 0; i < num_digits; ++i)
+    {
+        const size_t d = (half_e >> digit_offset(i)) & mask;
+        if (d != 0)
+        {
+            result *= powers[digit_offset(i)][d];
+        }
+    }
+
+    return result;
+}
+
+/*
+  Helpers for safegcd_inverse. Numbers are kept in a signed radix-2^60 form:
+  limbs 0..K-2 are in [0, 2^60) and the top limb carries the sign.
+ */
+namespace safegcd {
+
+const int64_t M60 = (int64_t)(UINT64_MAX >> 4);
+
+/* transition matrix of a batch of divsteps, scaled by 2^(number of divsteps) */
+struct trans2x2 {
+    int64_t u, v, q, r;
+};
+
+/*
+  Performs 30 divsteps on the low bits of f and g without branches. delta
+  is tracked as zeta = -delta; a divstep with delta > 0 and g odd maps
+  (delta, f, g) to (1 - delta, g, (g - f)/2), any other one to
+  (1 + delta, f, (g + (g mod 2) f)/2).
+
+  The matrix entries stay within 2^30 in absolute value, so u, v and q, r
+  are packed as u + 2^32 v and q + 2^32 r and updated together.
+ */
+inline int64_t divsteps_30(int64_t zeta, uint64_t f, uint64_t g, trans2x2 &t)
+{
+    uint64_t uv = 1, qr = (uint64_t)1 << 32;
+    for (size_t i = 0; i < 30; ++i)
+    {
+        /* c1 is all ones iff delta > 0, c2 iff g is odd */
+        uint64_t c1 = (uint64_t)(zeta >> 63);
+        const uint64_t c2 = -(g & 1);
+        /* g += (delta > 0 ? -f : f) if g is odd */
+        const uint64_t x = (f ^ c1) - c1;
+        const uint64_t y = (uv ^ c1) - c1;
+        g += x & c2;
+        qr += y & c2;
+        /* on a swap, f takes the old g (= new g + f) and zeta becomes ~zeta, otherwise zeta - 1 */
+        c1 &= c2;
+        zeta = (zeta ^ (int64_t)c1) - 1 - (int64_t)c1;
+        f += g & c1;
+        uv += qr & c1;
+        g >>= 1;
+        uv <<= 1;
+    }
+    t.u = (int64_t)(uv << 32) >> 32;
+    t.v = ((int64_t)uv - t.u) >> 32;
+    t.q = (int64_t)(qr << 32) >> 32;
+    t.r = ((int64_t)qr - t.q) >> 32;
+    return zeta;
+}
+
+/* 60 divsteps as two batches of 30; f and g only need to be correct mod 2^60 */
+inline int64_t divsteps_60(int64_t zeta, const uint64_t f, const uint64_t g, trans2x2 &t)
+{
+    trans2x2 t1, t2;
+    zeta = divsteps_30(zeta, f, g, t1);
+    const uint64_t f1 = ((uint64_t)t1.u * f + (uint64_t)t1.v * g) >> 30;
+    const uint64_t g1 = ((uint64_t)t1.q * f + (uint64_t)t1.r * g) >> 30;
+    zeta = divsteps_30(zeta, f1, g1, t2);
+
+    t.u = t2.u * t1.u + t2.v * t1.q;
+    t.v = t2.u * t1.v + t2.v * t1.r;
+    t.q = t2.q * t1.u + t2.r * t1.q;
+    t.r = t2.q * t1.v + t2.r * t1.r;
+    return zeta;
+}
+
+/*
+  Performs 60 "posdivsteps" in variable time, tracking the Jacobi symbol
+  (g | f) in the low bit of jac, after libsecp256k1. These keep f and g
+  non-negative: with eta = -delta, g is divided by 2 while even, and when
+  odd, f and g are swapped if eta < 0 and then g gets a multiple of f added
+  that clears as many low bits as possible at once. f and g are the low 64
+  bits of the actual values, as the symbol updates need f mod 8.
+ */
+inline int64_t posdivsteps_60_var(int64_t eta, uint64_t f, uint64_t g, trans2x2 &t, int &jac)
+{
+    uint64_t u = 1, v = 0, q = 0, r = 1;
+    int i = 60;
+    for (;;)
+    {
+        /* divide out the low zeros of g, but never more than i of them */
+        const int zeros = __builtin_ctzll(g | (UINT64_MAX << i));
+        g >>= zeros;
+        u <<= zeros;
+        v <<= zeros;
+        eta -= zeros;
+        i -= zeros;
+        /* (2 | f) = -1 iff f = 3, 5 (mod 8) */
+        jac ^= (zeros & (int)((f >> 1) ^ (f >> 2)));
+        if (i == 0)
+        {
+            break;
+        }
+
+        uint64_t w;
+        if (eta < 0)
+        {
+            eta = -eta;
+            std::swap(f, g);
+            std::swap(u, q);
+            std::swap(v, r);
+            /* quadratic reciprocity: the symbol flips iff f = g = 3 (mod 4) */
+            jac ^= (int)((f & g) >> 1);
+            /* cancel up to 6 bits of g, and no more than min(eta + 1, i) */
+            const int limit = std::min((int)eta + 1, i);
+            w = (f * g * (f * f - 2)) & (UINT64_MAX >> (64 - std::min(limit, 6)));
+        }
+        else
+        {
+            /* eta tends to be small here, so only cancel up to 4 bits */
+            const int limit = std::min((int)eta + 1, i);
+            w = f + (((f + 1) & 4) << 1);
+            w = (-w * g) & (UINT64_MAX >> (64 - std::min(limit, 4)));
+        }
+        g += f * w;
+        q += u * w;
+        r += v * w;
+    }
+
+    t.u = (int64_t)u;
+    t.v = (int64_t)v;
+    t.q = (int64_t)q;
+    t.r = (int64_t)r;
+    return eta;
+}
+
+/* [f, g] <- t * [f, g] / 2^60, which is exact */
+template<size_t K>
+void update_fg(int64_t (&f)[K], int64_t (&g)[K], const trans2x2 &t)
+{
+    __int128 cf = (__int128)t.u * f[0] + (__int128)t.v * g[0];
+    __int128 cg = (__int128)t.q * f[0] + (__int128)t.r * g[0];
+    assert(((int64_t)cf & M60) == 0 && ((int64_t)cg & M60) == 0);
+    cf >>= 60;
+    cg >>= 60;
+    for (size_t i = 1; i < K; ++i)
+    {
+        cf += (__int128)t.u * f[i] + (__int128)t.v * g[i];
+        cg += (__int128)t.q * f[i] + (__int128)t.r * g[i];
+        f[i-1] = (int64_t)cf & M60;
+        g[i-1] = (int64_t)cg & M60;
+        cf >>= 60;
+        cg >>= 60;
+    }
+    f[K-1] = (int64_t)cf;
+    g[K-1] = (int64_t)cg;
+}
+
+/*
+  [d, e] <- (t * [d, e] + modulus * [md, me]) / 2^60, with md and me chosen
+  to make the division exact. Keeps d and e in (-2*modulus, modulus).
+ */
+template<size_t K>
+void update_de(int64_t (&d)[K], int64_t (&e)[K], const trans2x2 &t,
+               const int64_t (&mod)[K], const uint64_t mod_inv60)
+{
+    /* start from modulus * [u, q] if d < 0 and modulus * [v, r] if e < 0 */
+    const int64_t sd = d[K-1] >> 63, se = e[K-1] >> 63;
+    int64_t md = (t.u & sd) + (t.v & se);
+    int64_t me = (t.q & sd) + (t.r & se);
+
+    __int128 cd = (__int128)t.u * d[0] + (__int128)t.v * e[0];
+    __int128 ce = (__int128)t.q * d[0] + (__int128)t.r * e[0];
+    /* adjust md and me so that the bottom 60 bits cancel */
+    md -= (int64_t)((mod_inv60 * (uint64_t)cd + (uint64_t)md) & (uint64_t)M60);
+    me -= (int64_t)((mod_inv60 * (uint64_t)ce + (uint64_t)me) & (uint64_t)M60);
+    cd += (__int128)mod[0] * md;
+    ce += (__int128)mod[0] * me;
+    assert(((int64_t)cd & M60) == 0 && ((int64_t)ce & M60) == 0);
+    cd >>= 60;
+    ce >>= 60;
+    for (size_t i = 1; i < K; ++i)
+    {
+        cd += (__int128)t.u * d[i] + (__int128)t.v * e[i] + (__int128)mod[i] * md;
+        ce += (__int128)t.q * d[i] + (__int128)t.r * e[i] + (__int128)mod[i] * me;
+        d[i-1] = (int64_t)cd & M60;
+        e[i-1] = (int64_t)ce & M60;
+        cd >>= 60;
+        ce >>= 60;
+    }
+    d[K-1] = (int64_t)cd;
+    e[K-1] = (int64_t)ce;
+}
+
+/* splits a into K limbs of 60 bits */
+template<size_t K, mp_size_t n>
+void to_radix60(int64_t (&x)[K], const bigint<n> &a)
+{
+    for (size_t i = 0; i < K; ++i)
+    {
+        const size_t bit = 60 * i, limb = bit / 64, shift = bit % 64;
+        uint64_t w = 0;
+        if (limb < (size_t)n)
+        {
+            w = a.data[limb] >> shift;
+        }
+        if (shift > 4 && limb + 1 < (size_t)n)
+        {
+            w |= a.data[limb+1] << (64 - shift);
+        }
+        x[i] = (int64_t)(w & (uint64_t)M60);
+    }
+}
+
+/* propagates carries so that limbs 0..K-2 are back in [0, 2^60) */
+template<size_t K>
+void normalize_limbs(int64_t (&x)[K])
+{
+    for (size_t i = 0; i + 1 < K; ++i)
+    {
+        x[i+1] += x[i] >> 60;
+        x[i] &= M60;
+    }
+}
+
+/* x += modulus if x < 0 */
+template<size_t K>
+void cond_add_modulus(int64_t (&x)[K], const int64_t (&mod)[K])
+{
+    const int64_t mask = x[K-1] >> 63;
+    for (size_t i = 0; i < K; ++i)
+    {
+        x[i] += mod[i] & mask;
+    }
+    normalize_limbs(x);
+}
+
+} // namespace safegcd
+
+template<mp_size_t n>
+bigint<n> safegcd_inverse(const bigint<n> &a, const bigint<n> &modulus, const size_t modulus_bits)
+{
+    static_assert(GMP_NUMB_BITS == 64, "safegcd_inverse assumes 64-bit limbs");
+    /* enough 60-bit limbs for n 64-bit ones plus a sign bit */
+    const size_t K = (64 * n) / 60 + 1;
+    const uint64_t M60 = (uint64_t)safegcd::M60;
+
+    assert(modulus.data[0] & 1);
+
+    int64_t mod[K], f[K], g[K], d[K], e[K];
+    safegcd::to_radix60(mod, modulus);
+    safegcd::to_radix60(g, a);
+    for (size_t i = 0; i < K; ++i)
+    {
+        f[i] = mod[i];
+        d[i] = 0;
+        e[i] = 0;
+    }
+    e[0] = 1;
+
+    /* modulus^(-1) mod 2^60 by Newton iteration; each step doubles the number of correct bits */
+    uint64_t mod_inv60 = modulus.data[0];
+    for (size_t i = 0; i < 5; ++i)
+    {
+        mod_inv60 *= 2 - modulus.data[0] * mod_inv60;
+    }
+    mod_inv60 &= M60;
+
+    /*
+      Bernstein-Yang, Theorem 11.2: starting from delta = 1, f = modulus and
+      g < modulus, g reaches 0 within floor((49d + 80)/17) divsteps, for d the
+      bit length of the modulus.
+     */
+    const size_t divsteps = (49 * modulus_bits + 80) / 17;
+    int64_t zeta = -1;
+    for (size_t i = 0; i < divsteps; i += 60)
+    {
+        safegcd::trans2x2 t;
+        zeta = safegcd::divsteps_60(zeta, (uint64_t)f[0], (uint64_t)g[0], t);
+        safegcd::update_de(d, e, t, mod, mod_inv60);
+        safegcd::update_fg(f, g, t);
+    }
+
+    /* now g = 0 and f = +-1, so a * d = f (mod modulus) */
+    safegcd::cond_add_modulus(d, mod);
+    const int64_t negate = f[K-1] >> 63;
+    for (size_t i = 0; i < K; ++i)
+    {
+        d[i] = (d[i] ^ negate) - negate;
+    }
+    safegcd::normalize_limbs(d);
+    safegcd::cond_add_modulus(d, mod);
+
+    bigint<n> result;
+    for (size_t i = 0; i < K; ++i)
+    {
+        const size_t bit = 60 * i, limb = bit / 64, shift = bit % 64;
+        if (limb < (size_t)n)
+        {
+            result.data[limb] |= (uint64_t)d[i] << shift;
+        }
+        if (shift > 4 && limb + 1 < (size_t)n)
+        {
+            result.data[limb+1] |= (uint64_t)d[i] >> (64 - shift);
+        }
+    }
+    return result;
+}
+
+
+template<mp_size_t n>
+int jacobi_symbol(const bigint<n> &a, const bigint<n> &modulus)
+{
+    static_assert(GMP_NUMB_BITS == 64, "jacobi_symbol assumes 64-bit limbs");
+    const size_t K = (64 * n) / 60 + 1;
+
+    assert(modulus.data[0] & 1);
+
+    if (a.is_zero())
+    {
+        return 0;
+    }
+
+    int64_t f[K], g[K];
+    safegcd::to_radix60(f, modulus);
+    safegcd::to_radix60(g, a);
+
+    /*
+      Posdivsteps converge to f = gcd(a, modulus) within about 6 steps per
+      bit of the modulus in practice, but there is no proven bound; if they
+      take longer, or the gcd is not 1, GMP decides.
+     */
+    const size_t max_iterations = (6 * 64 * n) / 60 + 2;
+    int64_t eta = -1;
+    int jac = 0;
+    for (size_t it = 0; it < max_iterations; ++it)
+    {
+        safegcd::trans2x2 t;
+        eta = safegcd::posdivsteps_60_var(eta, (uint64_t)f[0] | ((uint64_t)f[1] << 60),
+                                          (uint64_t)g[0] | ((uint64_t)g[1] << 60), t, jac);
+        safegcd::update_fg(f, g, t);
+
+        if (f[0] == 1)
+        {
+            int64_t rest = 0;
+            for (size_t i = 1; i < K; ++i)
+            {
+                rest |= f[i];
+            }
+            if (rest == 0)
+            {
+                return 1 - 2 * (jac & 1);
+            }
+        }
+    }
+
+    mpz_t a_mpz, modulus_mpz;
+    mpz_init(a_mpz);
+    mpz_init(modulus_mpz);
+    a.to_mpz(a_mpz);
+    modulus.to_mpz(modulus_mpz);
+    const int result = mpz_jacobi(a_mpz, modulus_mpz);
+    mpz_clear(a_mpz);
+    mpz_clear(modulus_mpz);
+    return result;
+}
 } // namespace libff
 
 #endif // ALGORITHMS_TCC_
@@ -18,6 +18,7 @@
 
 #include <gmp.h>
 
+#include <libff/algebra/field_utils/limbs.hpp>
 #include <libff/common/serialization.hpp>
 
 namespace libff {
@@ -60,7 +61,7 @@ public:
     void to_mpz(mpz_t r) const;
     bool test_bit(const std::size_t bitno) const;
 
-    bigint& randomize();
+    bigint& randomize(); /// Fills all limbs with random bits from thread_rng()
 
     friend std::ostream& operator<< <n>(std::ostream &out, const bigint<n> &b);
     friend std::istream& operator>> <n>(std::istream &in, bigint<n> &b);
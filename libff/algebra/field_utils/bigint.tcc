@@ -11,7 +11,8 @@
 #define BIGINT_TCC_
 #include <cassert>
 #include <cstring>
-#include <random>
+
+#include <libff/common/chacha20_rng.hpp>
 
 namespace libff {
 
@@ -54,8 +55,11 @@ bigint<n>::bigint(const mpz_t r) /// Initialize from MPZ element
 	mpz_t k;
     mpz_init_set(k, r);
 	
-	mp_limb_t *lptr = mpz_limbs_modify (k, n);
-	memcpy(data, lptr, n*sizeof(mp_limb_t));
+	/* limbs above mpz_size(k) are not defined, so zero them */
+	const size_t size = mpz_size(k);
+	assert(size <= (size_t)n);
+	memset(data, 0, n*sizeof(mp_limb_t));
+	memcpy(data, mpz_limbs_read(k), size*sizeof(mp_limb_t));
 
     //for (size_t i = 0; i < n; ++i)
     //{
@@ -91,7 +95,7 @@ void bigint<n>::print_hex() const
 template<mp_size_t n>
 bool bigint<n>::operator==(const bigint<n>& other) const
 {
-    return (mpn_cmp(this->data, other.data, n) == 0);
+    return (limbs_cmp<n>(this->data, other.data) == 0);
 }
 
 template<mp_size_t n>
@@ -103,13 +107,13 @@ bool bigint<n>::operator!=(const bigint<n>& other) const
 template<mp_size_t n>
 bool bigint<n>::operator<(const bigint<n>& other) const
 {
-    return (mpn_cmp(this->data, other.data, n) < 0);
+    return (limbs_cmp<n>(this->data, other.data) < 0);
 }
 
 template<mp_size_t n>
 void bigint<n>::clear()
 {
-    mpn_zero(this->data, n);
+    limbs_zero<n>(this->data);
 }
 
 template<mp_size_t n>
@@ -202,13 +206,7 @@ template<mp_size_t n>
 bigint<n>& bigint<n>::randomize()
 {
     static_assert(GMP_NUMB_BITS == sizeof(mp_limb_t) * 8, "Wrong GMP_NUMB_BITS value");
-	std::random_device rd;
-	constexpr size_t num_random_words = sizeof(mp_limb_t) * n / sizeof(std::random_device::result_type);
-	auto random_words = reinterpret_cast<std::random_device::result_type*>(this->data);
-	for (size_t i = 0; i < num_random_words; ++i)
-	{
-		random_words[i] = rd();
-	}
+    thread_rng().fill(this->data, sizeof(this->data));
 
     return (*this);
 }
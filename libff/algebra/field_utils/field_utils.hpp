@@ -51,6 +51,34 @@ FieldT convert_bit_vector_to_field_element(const bit_vector &v);
 template<typename FieldT>
 void batch_invert(std::vector<FieldT> &vec);
 
+/**
+ * Returns n uniformly random field elements. These come from the calling
+ * thread's generator (see chacha20_rng.hpp), so seeding thread_rng() makes
+ * the output reproducible.
+ */
+template<typename FieldT>
+std::vector<FieldT> random_vector(const std::size_t n);
+
+/**
+ * Elementwise vector arithmetic, in place: vec[i] = vec[i] op other[i] (or
+ * op c for batch_mul_scalar). vec and other must have the same length.
+ * Prime fields overload these with SIMD kernels, see fp.hpp.
+ */
+template<typename FieldT>
+void batch_add(std::vector<FieldT> &vec, const std::vector<FieldT> &other);
+
+template<typename FieldT>
+void batch_sub(std::vector<FieldT> &vec, const std::vector<FieldT> &other);
+
+template<typename FieldT>
+void batch_mul(std::vector<FieldT> &vec, const std::vector<FieldT> &other);
+
+template<typename FieldT>
+void batch_square(std::vector<FieldT> &vec);
+
+template<typename FieldT>
+void batch_mul_scalar(std::vector<FieldT> &vec, const FieldT &c);
+
 } // namespace libff
 #include <libff/algebra/field_utils/field_utils.tcc>
 
@@ -10,6 +10,8 @@
 #ifndef FIELD_UTILS_TCC_
 #define FIELD_UTILS_TCC_
 
+#include <algorithm>
+#include <cassert>
 #include <complex>
 #include <stdexcept>
 
@@ -171,25 +173,106 @@ FieldT convert_bit_vector_to_field_element(const bit_vector &v)
 template<typename FieldT>
 void batch_invert(std::vector<FieldT> &vec)
 {
-    std::vector<FieldT> prod;
-    prod.reserve(vec.size());
+    /*
+      Montgomery's trick on chunks of vec, in parallel under MULTICORE.
+      Each chunk inverts its own product, so the only scratch space is one
+      chunk of prefix products per thread. One inversion per chunk_size
+      elements adds about 1% to the three multiplications per element.
+     */
+    const size_t chunk_size = 1024;
+    const size_t num_chunks = (vec.size() + chunk_size - 1) / chunk_size;
+
+#ifdef MULTICORE
+#pragma omp parallel
+#endif
+    {
+        /* prefix[j] = product of the elements of the chunk before its j-th one */
+        std::vector<FieldT> prefix(std::min(vec.size(), chunk_size));
+#ifdef MULTICORE
+#pragma omp for
+#endif
+        for (size_t c = 0; c < num_chunks; ++c)
+        {
+            const size_t begin = c * chunk_size;
+            const size_t end = std::min(vec.size(), begin + chunk_size);
+
+            FieldT acc = FieldT::one();
+            for (size_t i = begin; i < end; ++i)
+            {
+                assert(!vec[i].is_zero());
+                prefix[i - begin] = acc;
+                acc *= vec[i];
+            }
+
+            FieldT acc_inverse = acc.inverse();
+            for (size_t i = end; i-- > begin; )
+            {
+                /* prefix[i - begin] is not needed anymore, so it holds the old vec[i] */
+                std::swap(prefix[i - begin], vec[i]);
+                vec[i] *= acc_inverse;
+                acc_inverse *= prefix[i - begin];
+            }
+        }
+    }
+}
+
+template<typename FieldT>
+std::vector<FieldT> random_vector(const size_t n)
+{
+    std::vector<FieldT> result;
+    result.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        result.emplace_back(FieldT::random_element());
+    }
+    return result;
+}
+
+template<typename FieldT>
+void batch_add(std::vector<FieldT> &vec, const std::vector<FieldT> &other)
+{
+    assert(vec.size() == other.size());
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        vec[i] += other[i];
+    }
+}
 
-    FieldT acc = FieldT::one();
+template<typename FieldT>
+void batch_sub(std::vector<FieldT> &vec, const std::vector<FieldT> &other)
+{
+    assert(vec.size() == other.size());
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        vec[i] -= other[i];
+    }
+}
 
-    for (auto el : vec)
+template<typename FieldT>
+void batch_mul(std::vector<FieldT> &vec, const std::vector<FieldT> &other)
+{
+    assert(vec.size() == other.size());
+    for (size_t i = 0; i < vec.size(); ++i)
     {
-        assert(!el.is_zero());
-        prod.emplace_back(acc);
-        acc = acc * el;
+        vec[i] *= other[i];
     }
+}
 
-    FieldT acc_inverse = acc.inverse();
+template<typename FieldT>
+void batch_square(std::vector<FieldT> &vec)
+{
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        vec[i].square();
+    }
+}
 
-    for (long i = static_cast<long>(vec.size()-1); i >= 0; --i)
+template<typename FieldT>
+void batch_mul_scalar(std::vector<FieldT> &vec, const FieldT &c)
+{
+    for (size_t i = 0; i < vec.size(); ++i)
     {
-        const FieldT old_el = vec[i];
-        vec[i] = acc_inverse * prod[i];
-        acc_inverse = acc_inverse * old_el;
+        vec[i] *= c;
     }
 }
 
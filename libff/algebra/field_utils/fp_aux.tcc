@@ -75,6 +75,52 @@ namespace libff {
     "movq    " STR(ofs) "(%[M]), %%rax    \n\t"         \
     "sbbq    %%rax, " STR(ofs) "(%[tmp])   \n\t"
 
+/*
+  Addition and subtraction in the redundant representation (see
+  Fp_is_redundant), with D pointing to 2p. The result is computed in
+  registers and stored to A; then 2p is subtracted from (added to) the
+  registers, and cmov moves the stored value back where that was not
+  needed. There are no branches.
+ */
+#define RADD_FIRSTADD(r)                                        \
+    "movq    (%[A]), %[" #r "]       \n\t"                      \
+    "addq    (%[B]), %[" #r "]       \n\t"
+
+#define RADD_NEXTADD(ofs, r)                                    \
+    "movq    " STR(ofs) "(%[A]), %[" #r "]   \n\t"              \
+    "adcq    " STR(ofs) "(%[B]), %[" #r "]   \n\t"
+
+#define RSUB_FIRSTSUB(r)                                        \
+    "movq    (%[A]), %[" #r "]       \n\t"                      \
+    "subq    (%[B]), %[" #r "]       \n\t"
+
+#define RSUB_NEXTSUB(ofs, r)                                    \
+    "movq    " STR(ofs) "(%[A]), %[" #r "]   \n\t"              \
+    "sbbq    " STR(ofs) "(%[B]), %[" #r "]   \n\t"
+
+#define RED_STORE(ofs, r)                                       \
+    "movq    %[" #r "], " STR(ofs) "(%[A])   \n\t"
+
+#define RED_FIRSTSUB_2P(r)                                      \
+    "subq    (%[D]), %[" #r "]       \n\t"
+
+#define RED_NEXTSUB_2P(ofs, r)                                  \
+    "sbbq    " STR(ofs) "(%[D]), %[" #r "]   \n\t"
+
+#define RED_FIRSTADD_2P(r)                                      \
+    "addq    (%[D]), %[" #r "]       \n\t"
+
+#define RED_NEXTADD_2P(ofs, r)                                  \
+    "adcq    " STR(ofs) "(%[D]), %[" #r "]   \n\t"
+
+/* restore A where subtracting 2p borrowed */
+#define RED_CMOVC(ofs, r)                                       \
+    "cmovcq  " STR(ofs) "(%[A]), %[" #r "]   \n\t"
+
+/* restore A where the subtraction did not borrow (rax = 0) */
+#define RED_CMOVZ(ofs, r)                                       \
+    "cmovzq  " STR(ofs) "(%[A]), %[" #r "]   \n\t"
+
 /*
   The x86-64 Montgomery multiplication here is similar
   to Algorithm 2 (CIOS method) in http://eprint.iacr.org/2012/140.pdf
@@ -151,6 +197,76 @@ namespace libff {
     "movq    %[T1], " STR((j*8)) "(%[tmp])       \n\t"          \
     "movq    %[cy], " STR(((j+1)*8)) "(%[tmp])       \n\t"
 
+/*
+  Montgomery multiplication using the BMI2 and ADX extensions, along the
+  lines of Gueron et al., "New Instructions Supporting Large Integer
+  Arithmetic on Intel Architecture Processors" (Intel white paper 327831).
+
+  mulx does not touch the flags, so each row of partial products is added
+  using two independent carry chains: adox for the low halves and adcx for
+  the high halves. The running value lives in the n+1 registers t0..tn.
+  After a reduction row, the lowest register is zero and becomes the new
+  top word, so the caller rotates the register names instead of moving
+  data. The result ends up in n of the registers and still needs a final
+  conditional subtraction. As with the CIOS code, the modulus must leave
+  the top bit of its most significant limb clear.
+
+  These are only used if the CPU supports the instructions, see
+  use_mulx_adx in common/utils.hpp.
+*/
+
+/* t1:t0 <- A[0] * B[0] */
+#define MULX_FIRSTROUND_BEGIN(t0, t1)                           \
+    "xorl    %%eax, %%eax            \n\t"                      \
+    "movq    0(%[A]), %%rdx          \n\t"                      \
+    "mulxq   0(%[B]), %[" #t0 "], %[" #t1 "]        \n\t"
+
+/* tj1:tj <- A[0] * B[j] + tj */
+#define MULX_FIRSTROUND_STEP(j, tj, tj1)                        \
+    "mulxq   " STR((j*8)) "(%[B]), %%rax, %[" #tj1 "]  \n\t"    \
+    "adcq    %%rax, %[" #tj "]       \n\t"
+
+#define MULX_FIRSTROUND_END(tn)                                 \
+    "adcq    $0, %[" #tn "]          \n\t"
+
+/* rdx <- A[i], and clear CF and OF */
+#define MULX_ROUND_BEGIN(i)                                     \
+    "xorl    %%eax, %%eax            \n\t"                      \
+    "movq    " STR((i*8)) "(%[A]), %%rdx       \n\t"
+
+/* tj1:tj += A[i] * B[j] */
+#define MULX_MUL_STEP(j, tj, tj1)                               \
+    "mulxq   " STR((j*8)) "(%[B]), %%rax, %[hi]    \n\t"        \
+    "adoxq   %%rax, %[" #tj "]       \n\t"                      \
+    "adcxq   %[hi], %[" #tj1 "]      \n\t"
+
+/* rdx <- t0 * inv, and clear CF and OF */
+#define MULX_REDUCE_BEGIN(t0)                                   \
+    "movq    %[" #t0 "], %%rdx       \n\t"                      \
+    "imulq   %[inv], %%rdx           \n\t"                      \
+    "xorl    %%eax, %%eax            \n\t"
+
+/* tj1:tj += u * M[j] */
+#define MULX_REDUCE_STEP(j, tj, tj1)                            \
+    "mulxq   " STR((j*8)) "(%[M]), %%rax, %[hi]    \n\t"        \
+    "adoxq   %%rax, %[" #tj "]       \n\t"                      \
+    "adcxq   %[hi], %[" #tj1 "]      \n\t"
+
+/* fold both pending carries into the top word (mov leaves the flags alone) */
+#define MULX_CARRY(tn)                                          \
+    "movl    $0, %%eax               \n\t"                      \
+    "adcxq   %%rax, %[" #tn "]       \n\t"                      \
+    "adoxq   %%rax, %[" #tn "]       \n\t"
+
+/*
+  For the double-width product without reduction (Fp_model::mul_unreduced),
+  each round ends by storing its lowest word, which is final, to R[i]; the
+  register is then cleared to become the new top word.
+ */
+#define MULX_STORE(i, ti)                                       \
+    "movq    %[" #ti "], " STR((i*8)) "(%[R])  \n\t"            \
+    "movq    $0, %[" #ti "]          \n\t"
+
 /*
   Comba multiplication and squaring routines are based on the
   public-domain tomsfastmath library by Tom St Denis
@@ -291,6 +407,379 @@ namespace libff {
         : [res] "r" (res_), [A] "r" (A_) \
         : "%rax", "%rdx", "cc", "memory")
 
+/*
+  Building blocks for larger Comba squarings. Column k of the product is
+  accumulated in the triple-word c2:c1:c0; the register names are passed in
+  so that the caller can rotate them between columns instead of moving data
+  around, as in COMBA_3_BY_3_SQR above.
+ */
+
+/* c2:c1:c0 += A[i] * A[i] */
+#define COMBA_SQR_DIAG(i, c0, c1, c2)                           \
+    "movq  " STR((i*8)) "(%[A]), %%rax         \n\t"            \
+    "mulq  %%rax                      \n\t"                     \
+    "addq  %%rax, %[" #c0 "]          \n\t"                     \
+    "adcq  %%rdx, %[" #c1 "]          \n\t"                     \
+    "adcq  $0, %[" #c2 "]             \n\t"
+
+/* c2:c1:c0 += 2 * A[i] * A[j] */
+#define COMBA_SQR_CROSS(i, j, c0, c1, c2)                       \
+    "movq  " STR((i*8)) "(%[A]), %%rax         \n\t"            \
+    "mulq  " STR((j*8)) "(%[A])                \n\t"            \
+    "addq  %%rax, %[" #c0 "]          \n\t"                     \
+    "adcq  %%rdx, %[" #c1 "]          \n\t"                     \
+    "adcq  $0, %[" #c2 "]             \n\t"                     \
+    "addq  %%rax, %[" #c0 "]          \n\t"                     \
+    "adcq  %%rdx, %[" #c1 "]          \n\t"                     \
+    "adcq  $0, %[" #c2 "]             \n\t"
+
+/* c2:c1:c0 += A[i] * B[j] */
+#define COMBA_MUL_TERM(i, j, c0, c1, c2)                        \
+    "movq  " STR((i*8)) "(%[A]), %%rax         \n\t"            \
+    "mulq  " STR((j*8)) "(%[B])                \n\t"            \
+    "addq  %%rax, %[" #c0 "]          \n\t"                     \
+    "adcq  %%rdx, %[" #c1 "]          \n\t"                     \
+    "adcq  $0, %[" #c2 "]             \n\t"
+
+/* res[k] <- c0, and clear c0 so that it can become the new top word */
+#define COMBA_STORE(k, c0)                                      \
+    "movq  %[" #c0 "], " STR((k*8)) "(%[res])  \n\t"            \
+    "xorq  %[" #c0 "], %[" #c0 "]     \n\t"
+
+#define COMBA_4_BY_4_MUL(c0_, c1_, c2_, res_, A_, B_)                   \
+    asm volatile (                                                      \
+        "xorq  %[c0], %[c0]               \n\t"                         \
+        "xorq  %[c1], %[c1]               \n\t"                         \
+        "xorq  %[c2], %[c2]               \n\t"                         \
+        COMBA_MUL_TERM(0, 0, c0, c1, c2)                                \
+        COMBA_STORE(0, c0)                                              \
+        COMBA_MUL_TERM(0, 1, c1, c2, c0)                                \
+        COMBA_MUL_TERM(1, 0, c1, c2, c0)                                \
+        COMBA_STORE(1, c1)                                              \
+        COMBA_MUL_TERM(0, 2, c2, c0, c1)                                \
+        COMBA_MUL_TERM(1, 1, c2, c0, c1)                                \
+        COMBA_MUL_TERM(2, 0, c2, c0, c1)                                \
+        COMBA_STORE(2, c2)                                              \
+        COMBA_MUL_TERM(0, 3, c0, c1, c2)                                \
+        COMBA_MUL_TERM(1, 2, c0, c1, c2)                                \
+        COMBA_MUL_TERM(2, 1, c0, c1, c2)                                \
+        COMBA_MUL_TERM(3, 0, c0, c1, c2)                                \
+        COMBA_STORE(3, c0)                                              \
+        COMBA_MUL_TERM(1, 3, c1, c2, c0)                                \
+        COMBA_MUL_TERM(2, 2, c1, c2, c0)                                \
+        COMBA_MUL_TERM(3, 1, c1, c2, c0)                                \
+        COMBA_STORE(4, c1)                                              \
+        COMBA_MUL_TERM(2, 3, c2, c0, c1)                                \
+        COMBA_MUL_TERM(3, 2, c2, c0, c1)                                \
+        COMBA_STORE(5, c2)                                              \
+        COMBA_MUL_TERM(3, 3, c0, c1, c2)                                \
+        "movq  %[c0], 48(%[res])          \n\t"                         \
+        "movq  %[c1], 56(%[res])          \n\t"                         \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_)          \
+        : [res] "r" (res_), [A] "r" (A_), [B] "r" (B_)                  \
+        : "%rax", "%rdx", "cc", "memory")
+
+#define COMBA_4_BY_4_SQR(c0_, c1_, c2_, res_, A_)                       \
+    asm volatile (                                                      \
+        "xorq  %[c0], %[c0]               \n\t"                         \
+        "xorq  %[c1], %[c1]               \n\t"                         \
+        "xorq  %[c2], %[c2]               \n\t"                         \
+        COMBA_SQR_DIAG(0, c0, c1, c2)                                   \
+        COMBA_STORE(0, c0)                                              \
+        COMBA_SQR_CROSS(0, 1, c1, c2, c0)                               \
+        COMBA_STORE(1, c1)                                              \
+        COMBA_SQR_CROSS(0, 2, c2, c0, c1)                               \
+        COMBA_SQR_DIAG(1, c2, c0, c1)                                   \
+        COMBA_STORE(2, c2)                                              \
+        COMBA_SQR_CROSS(0, 3, c0, c1, c2)                               \
+        COMBA_SQR_CROSS(1, 2, c0, c1, c2)                               \
+        COMBA_STORE(3, c0)                                              \
+        COMBA_SQR_CROSS(1, 3, c1, c2, c0)                               \
+        COMBA_SQR_DIAG(2, c1, c2, c0)                                   \
+        COMBA_STORE(4, c1)                                              \
+        COMBA_SQR_CROSS(2, 3, c2, c0, c1)                               \
+        COMBA_STORE(5, c2)                                              \
+        COMBA_SQR_DIAG(3, c0, c1, c2)                                   \
+        "movq  %[c0], 48(%[res])          \n\t"                         \
+        "movq  %[c1], 56(%[res])          \n\t"                         \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_)          \
+        : [res] "r" (res_), [A] "r" (A_)                                \
+        : "%rax", "%rdx", "cc", "memory")
+
+#define COMBA_5_BY_5_MUL(c0_, c1_, c2_, res_, A_, B_)                   \
+    asm volatile (                                                      \
+        "xorq  %[c0], %[c0]               \n\t"                         \
+        "xorq  %[c1], %[c1]               \n\t"                         \
+        "xorq  %[c2], %[c2]               \n\t"                         \
+        COMBA_MUL_TERM(0, 0, c0, c1, c2)                                \
+        COMBA_STORE(0, c0)                                              \
+        COMBA_MUL_TERM(0, 1, c1, c2, c0)                                \
+        COMBA_MUL_TERM(1, 0, c1, c2, c0)                                \
+        COMBA_STORE(1, c1)                                              \
+        COMBA_MUL_TERM(0, 2, c2, c0, c1)                                \
+        COMBA_MUL_TERM(1, 1, c2, c0, c1)                                \
+        COMBA_MUL_TERM(2, 0, c2, c0, c1)                                \
+        COMBA_STORE(2, c2)                                              \
+        COMBA_MUL_TERM(0, 3, c0, c1, c2)                                \
+        COMBA_MUL_TERM(1, 2, c0, c1, c2)                                \
+        COMBA_MUL_TERM(2, 1, c0, c1, c2)                                \
+        COMBA_MUL_TERM(3, 0, c0, c1, c2)                                \
+        COMBA_STORE(3, c0)                                              \
+        COMBA_MUL_TERM(0, 4, c1, c2, c0)                                \
+        COMBA_MUL_TERM(1, 3, c1, c2, c0)                                \
+        COMBA_MUL_TERM(2, 2, c1, c2, c0)                                \
+        COMBA_MUL_TERM(3, 1, c1, c2, c0)                                \
+        COMBA_MUL_TERM(4, 0, c1, c2, c0)                                \
+        COMBA_STORE(4, c1)                                              \
+        COMBA_MUL_TERM(1, 4, c2, c0, c1)                                \
+        COMBA_MUL_TERM(2, 3, c2, c0, c1)                                \
+        COMBA_MUL_TERM(3, 2, c2, c0, c1)                                \
+        COMBA_MUL_TERM(4, 1, c2, c0, c1)                                \
+        COMBA_STORE(5, c2)                                              \
+        COMBA_MUL_TERM(2, 4, c0, c1, c2)                                \
+        COMBA_MUL_TERM(3, 3, c0, c1, c2)                                \
+        COMBA_MUL_TERM(4, 2, c0, c1, c2)                                \
+        COMBA_STORE(6, c0)                                              \
+        COMBA_MUL_TERM(3, 4, c1, c2, c0)                                \
+        COMBA_MUL_TERM(4, 3, c1, c2, c0)                                \
+        COMBA_STORE(7, c1)                                              \
+        COMBA_MUL_TERM(4, 4, c2, c0, c1)                                \
+        "movq  %[c2], 64(%[res])          \n\t"                         \
+        "movq  %[c0], 72(%[res])          \n\t"                         \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_)          \
+        : [res] "r" (res_), [A] "r" (A_), [B] "r" (B_)                  \
+        : "%rax", "%rdx", "cc", "memory")
+
+#define COMBA_5_BY_5_SQR(c0_, c1_, c2_, res_, A_)                       \
+    asm volatile (                                                      \
+        "xorq  %[c0], %[c0]               \n\t"                         \
+        "xorq  %[c1], %[c1]               \n\t"                         \
+        "xorq  %[c2], %[c2]               \n\t"                         \
+        COMBA_SQR_DIAG(0, c0, c1, c2)                                   \
+        COMBA_STORE(0, c0)                                              \
+        COMBA_SQR_CROSS(0, 1, c1, c2, c0)                               \
+        COMBA_STORE(1, c1)                                              \
+        COMBA_SQR_CROSS(0, 2, c2, c0, c1)                               \
+        COMBA_SQR_DIAG(1, c2, c0, c1)                                   \
+        COMBA_STORE(2, c2)                                              \
+        COMBA_SQR_CROSS(0, 3, c0, c1, c2)                               \
+        COMBA_SQR_CROSS(1, 2, c0, c1, c2)                               \
+        COMBA_STORE(3, c0)                                              \
+        COMBA_SQR_CROSS(0, 4, c1, c2, c0)                               \
+        COMBA_SQR_CROSS(1, 3, c1, c2, c0)                               \
+        COMBA_SQR_DIAG(2, c1, c2, c0)                                   \
+        COMBA_STORE(4, c1)                                              \
+        COMBA_SQR_CROSS(1, 4, c2, c0, c1)                               \
+        COMBA_SQR_CROSS(2, 3, c2, c0, c1)                               \
+        COMBA_STORE(5, c2)                                              \
+        COMBA_SQR_CROSS(2, 4, c0, c1, c2)                               \
+        COMBA_SQR_DIAG(3, c0, c1, c2)                                   \
+        COMBA_STORE(6, c0)                                              \
+        COMBA_SQR_CROSS(3, 4, c1, c2, c0)                               \
+        COMBA_STORE(7, c1)                                              \
+        COMBA_SQR_DIAG(4, c2, c0, c1)                                   \
+        "movq  %[c2], 64(%[res])          \n\t"                         \
+        "movq  %[c0], 72(%[res])          \n\t"                         \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_)          \
+        : [res] "r" (res_), [A] "r" (A_)                                \
+        : "%rax", "%rdx", "cc", "memory")
+
+#define COMBA_6_BY_6_MUL(c0_, c1_, c2_, res_, A_, B_)                  \
+    asm volatile (                                                      \
+        "xorq  %[c0], %[c0]               \n\t"                         \
+        "xorq  %[c1], %[c1]               \n\t"                         \
+        "xorq  %[c2], %[c2]               \n\t"                         \
+        COMBA_MUL_TERM(0, 0, c0, c1, c2)                                \
+        COMBA_STORE(0, c0)                                              \
+        COMBA_MUL_TERM(0, 1, c1, c2, c0)                                \
+        COMBA_MUL_TERM(1, 0, c1, c2, c0)                                \
+        COMBA_STORE(1, c1)                                              \
+        COMBA_MUL_TERM(0, 2, c2, c0, c1)                                \
+        COMBA_MUL_TERM(1, 1, c2, c0, c1)                                \
+        COMBA_MUL_TERM(2, 0, c2, c0, c1)                                \
+        COMBA_STORE(2, c2)                                              \
+        COMBA_MUL_TERM(0, 3, c0, c1, c2)                                \
+        COMBA_MUL_TERM(1, 2, c0, c1, c2)                                \
+        COMBA_MUL_TERM(2, 1, c0, c1, c2)                                \
+        COMBA_MUL_TERM(3, 0, c0, c1, c2)                                \
+        COMBA_STORE(3, c0)                                              \
+        COMBA_MUL_TERM(0, 4, c1, c2, c0)                                \
+        COMBA_MUL_TERM(1, 3, c1, c2, c0)                                \
+        COMBA_MUL_TERM(2, 2, c1, c2, c0)                                \
+        COMBA_MUL_TERM(3, 1, c1, c2, c0)                                \
+        COMBA_MUL_TERM(4, 0, c1, c2, c0)                                \
+        COMBA_STORE(4, c1)                                              \
+        COMBA_MUL_TERM(0, 5, c2, c0, c1)                                \
+        COMBA_MUL_TERM(1, 4, c2, c0, c1)                                \
+        COMBA_MUL_TERM(2, 3, c2, c0, c1)                                \
+        COMBA_MUL_TERM(3, 2, c2, c0, c1)                                \
+        COMBA_MUL_TERM(4, 1, c2, c0, c1)                                \
+        COMBA_MUL_TERM(5, 0, c2, c0, c1)                                \
+        COMBA_STORE(5, c2)                                              \
+        COMBA_MUL_TERM(1, 5, c0, c1, c2)                                \
+        COMBA_MUL_TERM(2, 4, c0, c1, c2)                                \
+        COMBA_MUL_TERM(3, 3, c0, c1, c2)                                \
+        COMBA_MUL_TERM(4, 2, c0, c1, c2)                                \
+        COMBA_MUL_TERM(5, 1, c0, c1, c2)                                \
+        COMBA_STORE(6, c0)                                              \
+        COMBA_MUL_TERM(2, 5, c1, c2, c0)                                \
+        COMBA_MUL_TERM(3, 4, c1, c2, c0)                                \
+        COMBA_MUL_TERM(4, 3, c1, c2, c0)                                \
+        COMBA_MUL_TERM(5, 2, c1, c2, c0)                                \
+        COMBA_STORE(7, c1)                                              \
+        COMBA_MUL_TERM(3, 5, c2, c0, c1)                                \
+        COMBA_MUL_TERM(4, 4, c2, c0, c1)                                \
+        COMBA_MUL_TERM(5, 3, c2, c0, c1)                                \
+        COMBA_STORE(8, c2)                                              \
+        COMBA_MUL_TERM(4, 5, c0, c1, c2)                                \
+        COMBA_MUL_TERM(5, 4, c0, c1, c2)                                \
+        COMBA_STORE(9, c0)                                              \
+        COMBA_MUL_TERM(5, 5, c1, c2, c0)                                \
+        "movq  %[c1], 80(%[res])          \n\t"                         \
+        "movq  %[c2], 88(%[res])          \n\t"                         \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_)          \
+        : [res] "r" (res_), [A] "r" (A_), [B] "r" (B_)                  \
+        : "%rax", "%rdx", "cc", "memory")
+
+#define COMBA_6_BY_6_SQR(c0_, c1_, c2_, res_, A_)                      \
+    asm volatile (                                                      \
+        "xorq  %[c0], %[c0]               \n\t"                         \
+        "xorq  %[c1], %[c1]               \n\t"                         \
+        "xorq  %[c2], %[c2]               \n\t"                         \
+        COMBA_SQR_DIAG(0, c0, c1, c2)                                   \
+        COMBA_STORE(0, c0)                                              \
+        COMBA_SQR_CROSS(0, 1, c1, c2, c0)                               \
+        COMBA_STORE(1, c1)                                              \
+        COMBA_SQR_CROSS(0, 2, c2, c0, c1)                               \
+        COMBA_SQR_DIAG(1, c2, c0, c1)                                   \
+        COMBA_STORE(2, c2)                                              \
+        COMBA_SQR_CROSS(0, 3, c0, c1, c2)                               \
+        COMBA_SQR_CROSS(1, 2, c0, c1, c2)                               \
+        COMBA_STORE(3, c0)                                              \
+        COMBA_SQR_CROSS(0, 4, c1, c2, c0)                               \
+        COMBA_SQR_CROSS(1, 3, c1, c2, c0)                               \
+        COMBA_SQR_DIAG(2, c1, c2, c0)                                   \
+        COMBA_STORE(4, c1)                                              \
+        COMBA_SQR_CROSS(0, 5, c2, c0, c1)                               \
+        COMBA_SQR_CROSS(1, 4, c2, c0, c1)                               \
+        COMBA_SQR_CROSS(2, 3, c2, c0, c1)                               \
+        COMBA_STORE(5, c2)                                              \
+        COMBA_SQR_CROSS(1, 5, c0, c1, c2)                               \
+        COMBA_SQR_CROSS(2, 4, c0, c1, c2)                               \
+        COMBA_SQR_DIAG(3, c0, c1, c2)                                   \
+        COMBA_STORE(6, c0)                                              \
+        COMBA_SQR_CROSS(2, 5, c1, c2, c0)                               \
+        COMBA_SQR_CROSS(3, 4, c1, c2, c0)                               \
+        COMBA_STORE(7, c1)                                              \
+        COMBA_SQR_CROSS(3, 5, c2, c0, c1)                               \
+        COMBA_SQR_DIAG(4, c2, c0, c1)                                   \
+        COMBA_STORE(8, c2)                                              \
+        COMBA_SQR_CROSS(4, 5, c0, c1, c2)                               \
+        COMBA_STORE(9, c0)                                              \
+        COMBA_SQR_DIAG(5, c1, c2, c0)                                   \
+        "movq  %[c1], 80(%[res])          \n\t"                         \
+        "movq  %[c2], 88(%[res])          \n\t"                         \
+        : [c0] "=&r" (c0_), [c1] "=&r" (c1_), [c2] "=&r" (c2_)          \
+        : [res] "r" (res_), [A] "r" (A_)                                \
+        : "%rax", "%rdx", "cc", "memory")
+
+/*
+  Word-by-word Montgomery reduction of a 2n-limb product held in res[],
+  i.e. Algorithm 14.32 of the Handbook of Applied Cryptography again, but
+  with the carry out of each row kept in a register instead of being
+  propagated through all the upper limbs (as REDUCE_6_LIMB_PRODUCT does).
+
+  Row i computes k = res[i] * inv and adds k * M * b^i to res; the reduced
+  value ends up in res[n..2n-1]. As in the CIOS code, the final carry word
+  is dropped, which is only correct when the modulus leaves the top bit of
+  its most significant limb clear.
+ */
+#define REDC_FIRSTMUL(i)                                        \
+    "movq    " STR((i*8)) "(%[res]), %%rax       \n\t"          \
+    "mulq    %[modprime]                 \n\t"                  \
+    "movq    %%rax, %[k]                 \n\t"                  \
+    "mulq    0(%[mod])                   \n\t"                  \
+    "addq    %%rax, " STR((i*8)) "(%[res])       \n\t"          \
+    "adcq    $0, %%rdx                   \n\t"                  \
+    "movq    %%rdx, %[hi]                \n\t"
+
+#define REDC_NEXTMUL(i, j)                                      \
+    "movq    " STR((j*8)) "(%[mod]), %%rax       \n\t"          \
+    "mulq    %[k]                        \n\t"                  \
+    "addq    %[hi], %%rax                \n\t"                  \
+    "adcq    $0, %%rdx                   \n\t"                  \
+    "addq    %%rax, " STR(((i+j)*8)) "(%[res])   \n\t"          \
+    "adcq    $0, %%rdx                   \n\t"                  \
+    "movq    %%rdx, %[hi]                \n\t"
+
+/* res[i+n] += hi + cy, with the new carry (at most 1) left in cy */
+#define REDC_CARRY(ofs)                                         \
+    "addq    %[cy], %[hi]                \n\t"                  \
+    "movq    $0, %[cy]                   \n\t"                  \
+    "adcq    $0, %[cy]                   \n\t"                  \
+    "addq    %[hi], " STR(ofs) "(%[res])         \n\t"          \
+    "adcq    $0, %[cy]                   \n\t"
+
+#define REDC_4_LIMB_ROW(i)                      \
+    REDC_FIRSTMUL(i)                            \
+    REDC_NEXTMUL(i, 1)                          \
+    REDC_NEXTMUL(i, 2)                          \
+    REDC_NEXTMUL(i, 3)                          \
+    REDC_CARRY(((i+4)*8))
+
+#define REDUCE_8_LIMB_PRODUCT(k_, hi_, cy_, inv_, res_, mod_)           \
+    __asm__ volatile                                                    \
+        ("xorq    %[cy], %[cy]                \n\t"                     \
+         REDC_4_LIMB_ROW(0)                                             \
+         REDC_4_LIMB_ROW(1)                                             \
+         REDC_4_LIMB_ROW(2)                                             \
+         REDC_4_LIMB_ROW(3)                                             \
+         : [k] "=&r" (k_), [hi] "=&r" (hi_), [cy] "=&r" (cy_)           \
+         : [modprime] "r" (inv_), [res] "r" (res_), [mod] "r" (mod_)    \
+         : "%rax", "%rdx", "cc", "memory")
+
+#define REDC_5_LIMB_ROW(i)                      \
+    REDC_FIRSTMUL(i)                            \
+    REDC_NEXTMUL(i, 1)                          \
+    REDC_NEXTMUL(i, 2)                          \
+    REDC_NEXTMUL(i, 3)                          \
+    REDC_NEXTMUL(i, 4)                          \
+    REDC_CARRY(((i+5)*8))
+
+#define REDUCE_10_LIMB_PRODUCT(k_, hi_, cy_, inv_, res_, mod_)          \
+    __asm__ volatile                                                    \
+        ("xorq    %[cy], %[cy]                \n\t"                     \
+         REDC_5_LIMB_ROW(0)                                             \
+         REDC_5_LIMB_ROW(1)                                             \
+         REDC_5_LIMB_ROW(2)                                             \
+         REDC_5_LIMB_ROW(3)                                             \
+         REDC_5_LIMB_ROW(4)                                             \
+         : [k] "=&r" (k_), [hi] "=&r" (hi_), [cy] "=&r" (cy_)           \
+         : [modprime] "r" (inv_), [res] "r" (res_), [mod] "r" (mod_)    \
+         : "%rax", "%rdx", "cc", "memory")
+
+#define REDC_6_LIMB_ROW(i)                      \
+    REDC_FIRSTMUL(i)                            \
+    REDC_NEXTMUL(i, 1)                          \
+    REDC_NEXTMUL(i, 2)                          \
+    REDC_NEXTMUL(i, 3)                          \
+    REDC_NEXTMUL(i, 4)                          \
+    REDC_NEXTMUL(i, 5)                          \
+    REDC_CARRY(((i+6)*8))
+
+#define REDUCE_12_LIMB_PRODUCT(k_, hi_, cy_, inv_, res_, mod_)         \
+    __asm__ volatile                                                    \
+        ("xorq    %[cy], %[cy]                \n\t"                     \
+         REDC_6_LIMB_ROW(0)                                             \
+         REDC_6_LIMB_ROW(1)                                             \
+         REDC_6_LIMB_ROW(2)                                             \
+         REDC_6_LIMB_ROW(3)                                             \
+         REDC_6_LIMB_ROW(4)                                             \
+         REDC_6_LIMB_ROW(5)                                             \
+         : [k] "=&r" (k_), [hi] "=&r" (hi_), [cy] "=&r" (cy_)           \
+         : [modprime] "r" (inv_), [res] "r" (res_), [mod] "r" (mod_)    \
+         : "%rax", "%rdx", "cc", "memory")
+
 /*
   The Montgomery reduction here is based on Algorithm 14.32 in
   Handbook of Applied Cryptography
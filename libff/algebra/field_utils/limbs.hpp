@@ -0,0 +1,65 @@
+/** @file
+ *****************************************************************************
+ Declaration of fixed-width arithmetic on arrays of limbs.
+
+ These are the mpn functions that bigint and Fp_model need, with the number
+ of limbs n a template parameter: with the loops unrolled for each n they
+ compile to straight-line code, instead of the length-generic calls into
+ GMP. GMP itself is only needed for string parsing and mpz interop.
+
+ As with GMP, limb 0 is the least significant and the result may alias an
+ input, except for the outputs of limbs_mul and limbs_sqr.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef LIMBS_HPP_
+#define LIMBS_HPP_
+#include <cstdint>
+
+#include <gmp.h>
+
+namespace libff {
+
+/* an unsigned integer of two limbs, holding limb products and carries */
+#if GMP_NUMB_BITS == 64
+typedef unsigned __int128 dlimb_t;
+#elif GMP_NUMB_BITS == 32
+typedef uint64_t dlimb_t;
+#else
+#error "limbs.hpp supports only 32- and 64-bit limbs"
+#endif
+
+/// r = a
+template<mp_size_t n> void limbs_copy(mp_limb_t *r, const mp_limb_t *a);
+/// r = 0
+template<mp_size_t n> void limbs_zero(mp_limb_t *r);
+/// Returns 1, 0 or -1 as a >, = or < b
+template<mp_size_t n> int limbs_cmp(const mp_limb_t *a, const mp_limb_t *b);
+
+/// r = a + b, returning the carry out
+template<mp_size_t n> mp_limb_t limbs_add(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b);
+/// r = a - b, returning the borrow out
+template<mp_size_t n> mp_limb_t limbs_sub(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b);
+/// r = a + b for a single limb b, returning the carry out
+template<mp_size_t n> mp_limb_t limbs_add_1(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t b);
+/// r = a - b for a single limb b, returning the borrow out
+template<mp_size_t n> mp_limb_t limbs_sub_1(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t b);
+
+/// r = a << shift for 0 < shift < GMP_NUMB_BITS, returning the bits shifted out in the low bits, like mpn_lshift
+template<mp_size_t n> mp_limb_t limbs_lshift(mp_limb_t *r, const mp_limb_t *a, const unsigned shift);
+/// r = a >> shift for 0 < shift < GMP_NUMB_BITS, returning the bits shifted out in the high bits, like mpn_rshift
+template<mp_size_t n> mp_limb_t limbs_rshift(mp_limb_t *r, const mp_limb_t *a, const unsigned shift);
+
+/// r[0..2n-1] = a * b
+template<mp_size_t n> void limbs_mul(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b);
+/// r[0..2n-1] = a * a, computing each cross product once
+template<mp_size_t n> void limbs_sqr(mp_limb_t *r, const mp_limb_t *a);
+/// r = r + a * b for a single limb b, returning the carry limb
+template<mp_size_t n> mp_limb_t limbs_addmul_1(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t b);
+
+} // namespace libff
+#include <libff/algebra/field_utils/limbs.tcc>
+#endif // LIMBS_HPP_
@@ -0,0 +1,214 @@
+/** @file
+ *****************************************************************************
+ Implementation of fixed-width arithmetic on arrays of limbs.
+
+ See limbs.hpp .
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef LIMBS_TCC_
+#define LIMBS_TCC_
+
+/* n is a compile-time constant, so every loop below is meant to be fully unrolled */
+#define LIMBS_UNROLL _Pragma("GCC unroll 16")
+
+namespace libff {
+
+template<mp_size_t n>
+void limbs_copy(mp_limb_t *r, const mp_limb_t *a)
+{
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        r[i] = a[i];
+    }
+}
+
+template<mp_size_t n>
+void limbs_zero(mp_limb_t *r)
+{
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        r[i] = 0;
+    }
+}
+
+template<mp_size_t n>
+int limbs_cmp(const mp_limb_t *a, const mp_limb_t *b)
+{
+    LIMBS_UNROLL
+    for (mp_size_t i = n-1; i >= 0; --i)
+    {
+        if (a[i] != b[i])
+        {
+            return (a[i] > b[i] ? 1 : -1);
+        }
+    }
+    return 0;
+}
+
+template<mp_size_t n>
+mp_limb_t limbs_add(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b)
+{
+    dlimb_t c = 0;
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        c += (dlimb_t)a[i] + b[i];
+        r[i] = (mp_limb_t)c;
+        c >>= GMP_NUMB_BITS;
+    }
+    return (mp_limb_t)c;
+}
+
+template<mp_size_t n>
+mp_limb_t limbs_sub(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b)
+{
+    mp_limb_t borrow = 0;
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        const mp_limb_t ai = a[i], bi = b[i];
+        const mp_limb_t x = ai - bi;
+        r[i] = x - borrow;
+        borrow = (mp_limb_t)(ai < bi) | (mp_limb_t)(x < borrow);
+    }
+    return borrow;
+}
+
+template<mp_size_t n>
+mp_limb_t limbs_add_1(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t b)
+{
+    dlimb_t c = b;
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        c += a[i];
+        r[i] = (mp_limb_t)c;
+        c >>= GMP_NUMB_BITS;
+    }
+    return (mp_limb_t)c;
+}
+
+template<mp_size_t n>
+mp_limb_t limbs_sub_1(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t b)
+{
+    mp_limb_t borrow = b;
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        const mp_limb_t ai = a[i];
+        r[i] = ai - borrow;
+        borrow = (mp_limb_t)(ai < borrow);
+    }
+    return borrow;
+}
+
+template<mp_size_t n>
+mp_limb_t limbs_lshift(mp_limb_t *r, const mp_limb_t *a, const unsigned shift)
+{
+    /* from the top limb down, so that r may alias a */
+    const mp_limb_t out = a[n-1] >> (GMP_NUMB_BITS - shift);
+    LIMBS_UNROLL
+    for (mp_size_t i = n-1; i > 0; --i)
+    {
+        r[i] = (a[i] << shift) | (a[i-1] >> (GMP_NUMB_BITS - shift));
+    }
+    r[0] = a[0] << shift;
+    return out;
+}
+
+template<mp_size_t n>
+mp_limb_t limbs_rshift(mp_limb_t *r, const mp_limb_t *a, const unsigned shift)
+{
+    const mp_limb_t out = a[0] << (GMP_NUMB_BITS - shift);
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n-1; ++i)
+    {
+        r[i] = (a[i] >> shift) | (a[i+1] << (GMP_NUMB_BITS - shift));
+    }
+    r[n-1] = a[n-1] >> shift;
+    return out;
+}
+
+template<mp_size_t n>
+void limbs_mul(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t *b)
+{
+    /* operand scanning: row i adds a * b[i] into r[i..i+n] */
+    limbs_zero<n>(r);
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        dlimb_t c = 0;
+        LIMBS_UNROLL
+        for (mp_size_t j = 0; j < n; ++j)
+        {
+            c += (dlimb_t)a[j] * b[i] + r[i+j];
+            r[i+j] = (mp_limb_t)c;
+            c >>= GMP_NUMB_BITS;
+        }
+        r[i+n] = (mp_limb_t)c;
+    }
+}
+
+template<mp_size_t n>
+void limbs_sqr(mp_limb_t *r, const mp_limb_t *a)
+{
+    /* the cross products a[i] * a[j] for i < j ... */
+    limbs_zero<2*n>(r);
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n-1; ++i)
+    {
+        dlimb_t c = 0;
+        LIMBS_UNROLL
+        for (mp_size_t j = i+1; j < n; ++j)
+        {
+            c += (dlimb_t)a[i] * a[j] + r[i+j];
+            r[i+j] = (mp_limb_t)c;
+            c >>= GMP_NUMB_BITS;
+        }
+        r[i+n] = (mp_limb_t)c;
+    }
+
+    /* ... doubled, plus the squares a[i]^2 on the diagonal */
+    mp_limb_t top = 0;
+    dlimb_t c = 0;
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        const dlimb_t sq = (dlimb_t)a[i] * a[i];
+        const mp_limb_t lo = r[2*i], hi = r[2*i+1];
+
+        c += (dlimb_t)((lo << 1) | top) + (mp_limb_t)sq;
+        r[2*i] = (mp_limb_t)c;
+        c >>= GMP_NUMB_BITS;
+        c += (dlimb_t)((hi << 1) | (lo >> (GMP_NUMB_BITS - 1))) + (mp_limb_t)(sq >> GMP_NUMB_BITS);
+        r[2*i+1] = (mp_limb_t)c;
+        c >>= GMP_NUMB_BITS;
+        top = hi >> (GMP_NUMB_BITS - 1);
+    }
+}
+
+template<mp_size_t n>
+mp_limb_t limbs_addmul_1(mp_limb_t *r, const mp_limb_t *a, const mp_limb_t b)
+{
+    dlimb_t c = 0;
+    LIMBS_UNROLL
+    for (mp_size_t i = 0; i < n; ++i)
+    {
+        c += (dlimb_t)a[i] * b + r[i];
+        r[i] = (mp_limb_t)c;
+        c >>= GMP_NUMB_BITS;
+    }
+    return (mp_limb_t)c;
+}
+
+} // namespace libff
+
+#undef LIMBS_UNROLL
+
+#endif // LIMBS_TCC_
@@ -6,8 +6,14 @@
  *             and contributors (see AUTHORS).
  * @copyright  MIT license (see LICENSE file)
  *****************************************************************************/
+#include "libff/algebra/field_utils/algorithms.hpp"
 #include "libff/algebra/field_utils/bigint.hpp"
+#include "libff/algebra/field_utils/limbs.hpp"
+#include "libff/common/chacha20_rng.hpp"
+#include "libff/common/sha512_multi.hpp"
 #include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace libff;
 
@@ -60,3 +66,308 @@ TEST(FieldUtilsTest, BigintTest)
     x.clear();
     EXPECT_EQ(x, zero);
 }
+
+template<mp_size_t n>
+void test_limbs()
+{
+    for (size_t i = 0; i < 100; i++)
+    {
+        bigint<n> a, b;
+        a.randomize();
+        b.randomize();
+        if (i == 0)
+        {
+            b = a; // equal operands
+        }
+        else if (i == 1)
+        {
+            for (mp_size_t j = 0; j < n; j++)
+            {
+                a.data[j] = b.data[j] = ~mp_limb_t(0); // all carries set
+            }
+        }
+        const mp_limb_t x = b.data[0];
+        const unsigned shift = 1 + (b.data[n-1] % (GMP_NUMB_BITS - 1));
+
+        mp_limb_t expected[2*n], result[2*n];
+        EXPECT_EQ(limbs_cmp<n>(a.data, b.data), mpn_cmp(a.data, b.data, n));
+        EXPECT_EQ(limbs_add<n>(result, a.data, b.data), mpn_add_n(expected, a.data, b.data, n));
+        EXPECT_EQ(memcmp(result, expected, n * sizeof(mp_limb_t)), 0);
+        EXPECT_EQ(limbs_sub<n>(result, a.data, b.data), mpn_sub_n(expected, a.data, b.data, n));
+        EXPECT_EQ(memcmp(result, expected, n * sizeof(mp_limb_t)), 0);
+        EXPECT_EQ(limbs_add_1<n>(result, a.data, x), mpn_add_1(expected, a.data, n, x));
+        EXPECT_EQ(memcmp(result, expected, n * sizeof(mp_limb_t)), 0);
+        EXPECT_EQ(limbs_sub_1<n>(result, a.data, x), mpn_sub_1(expected, a.data, n, x));
+        EXPECT_EQ(memcmp(result, expected, n * sizeof(mp_limb_t)), 0);
+        EXPECT_EQ(limbs_lshift<n>(result, a.data, shift), mpn_lshift(expected, a.data, n, shift));
+        EXPECT_EQ(memcmp(result, expected, n * sizeof(mp_limb_t)), 0);
+        EXPECT_EQ(limbs_rshift<n>(result, a.data, shift), mpn_rshift(expected, a.data, n, shift));
+        EXPECT_EQ(memcmp(result, expected, n * sizeof(mp_limb_t)), 0);
+
+        limbs_mul<n>(result, a.data, b.data);
+        mpn_mul_n(expected, a.data, b.data, n);
+        EXPECT_EQ(memcmp(result, expected, 2 * n * sizeof(mp_limb_t)), 0);
+        limbs_sqr<n>(result, a.data);
+        mpn_sqr(expected, a.data, n);
+        EXPECT_EQ(memcmp(result, expected, 2 * n * sizeof(mp_limb_t)), 0);
+
+        limbs_copy<n>(result, b.data);
+        limbs_copy<n>(expected, b.data);
+        EXPECT_EQ(limbs_addmul_1<n>(result, a.data, x), mpn_addmul_1(expected, a.data, n, x));
+        EXPECT_EQ(memcmp(result, expected, n * sizeof(mp_limb_t)), 0);
+
+        /* in place, as bigint and Fp_model use them */
+        limbs_copy<n>(result, a.data);
+        limbs_rshift<n>(result, result, shift);
+        limbs_lshift<n>(result, result, shift);
+        mpn_rshift(expected, a.data, n, shift);
+        mpn_lshift(expected, expected, n, shift);
+        EXPECT_EQ(memcmp(result, expected, n * sizeof(mp_limb_t)), 0);
+        limbs_zero<n>(a.data);
+        EXPECT_TRUE(a.is_zero());
+    }
+}
+
+TEST(FieldUtilsTest, LimbsTest)
+{
+    test_limbs<1>();
+    test_limbs<2>();
+    test_limbs<3>();
+    test_limbs<4>();
+    test_limbs<5>();
+    test_limbs<6>();
+    test_limbs<8>();
+}
+
+template<mp_size_t n>
+void test_safegcd_inverse(const bigint<n> &modulus)
+{
+    mpz_t m, a, a_inv;
+    mpz_init(m);
+    mpz_init(a);
+    mpz_init(a_inv);
+    modulus.to_mpz(m);
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        bigint<n> x;
+        x.randomize();
+        x.to_mpz(a);
+        mpz_mod(a, a, m);
+        if (i == 0)
+        {
+            mpz_set_ui(a, 1);
+        }
+        else if (i == 1)
+        {
+            mpz_sub_ui(a, m, 1);
+        }
+        if (mpz_sgn(a) == 0 || mpz_invert(a_inv, a, m) == 0)
+        {
+            continue;
+        }
+
+        const bigint<n> result = safegcd_inverse(bigint<n>(a), modulus, modulus.num_bits());
+        EXPECT_EQ(result, bigint<n>(a_inv));
+    }
+
+    mpz_clear(m);
+    mpz_clear(a);
+    mpz_clear(a_inv);
+}
+
+TEST(FieldUtilsTest, SafegcdInverseTest)
+{
+    test_safegcd_inverse<1>(bigint<1>("2305843009213693951")); // 2^61 - 1
+    test_safegcd_inverse<1>(bigint<1>("18446744073709551557")); // 2^64 - 59
+    test_safegcd_inverse<2>(bigint<2>("340282366920938463463374607431768211297")); // 2^128 - 159
+    test_safegcd_inverse<2>(bigint<2>("99999999999999999999999999999999999999")); // odd, not prime
+    test_safegcd_inverse<3>(bigint<3>("6277101735386680763835789423207666416102355444464034512659"));
+}
+
+template<mp_size_t n>
+void test_jacobi_symbol(const bigint<n> &modulus)
+{
+    mpz_t m, a;
+    mpz_init(m);
+    mpz_init(a);
+    modulus.to_mpz(m);
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        bigint<n> x;
+        x.randomize();
+        x.to_mpz(a);
+        mpz_mod(a, a, m);
+        if (i < 3)
+        {
+            mpz_set_ui(a, i); // 0, 1 and 2
+        }
+        else if (i == 3)
+        {
+            mpz_sub_ui(a, m, 1);
+        }
+        else if (i == 4)
+        {
+            mpz_set_ui(a, 3); // shares a factor with the composite modulus
+        }
+
+        EXPECT_EQ(jacobi_symbol(bigint<n>(a), modulus), mpz_jacobi(a, m));
+    }
+
+    mpz_clear(m);
+    mpz_clear(a);
+}
+
+TEST(FieldUtilsTest, JacobiSymbolTest)
+{
+    test_jacobi_symbol<1>(bigint<1>("2305843009213693951")); // 2^61 - 1
+    test_jacobi_symbol<1>(bigint<1>("18446744073709551557")); // 2^64 - 59
+    test_jacobi_symbol<2>(bigint<2>("340282366920938463463374607431768211297")); // 2^128 - 159
+    test_jacobi_symbol<2>(bigint<2>("99999999999999999999999999999999999999")); // odd, not prime
+    test_jacobi_symbol<3>(bigint<3>("6277101735386680763835789423207666416102355444464034512659"));
+}
+
+TEST(FieldUtilsTest, SlidingWindowTest)
+{
+    /* 0b101100011101 with w = 3: windows 101, 1, 111 and 1 */
+    const std::vector<long> expected = { 1, 0, 7, 0, 0, 0, 0, 0, 1, 5, 0, 0 };
+    EXPECT_EQ(find_sliding_window(3, bigint<1>(0xb1dul)), expected);
+    EXPECT_TRUE(find_sliding_window(4, bigint<1>(0ul)).empty());
+
+    mpz_t e, sum;
+    mpz_init(e);
+    mpz_init(sum);
+    for (size_t w = 1; w <= 8; w++)
+    {
+        bigint<3> exponent;
+        exponent.randomize();
+        exponent.to_mpz(e);
+
+        const std::vector<long> digits = find_sliding_window(w, exponent);
+        EXPECT_EQ(digits.size(), exponent.num_bits());
+        mpz_set_ui(sum, 0);
+        for (size_t i = digits.size(); i-- > 0; )
+        {
+            EXPECT_TRUE(digits[i] == 0 || (digits[i] % 2 == 1 && digits[i] < (1l << w)));
+            mpz_mul_2exp(sum, sum, 1);
+            mpz_add_ui(sum, sum, digits[i]);
+        }
+        EXPECT_EQ(mpz_cmp(sum, e), 0);
+    }
+    mpz_clear(e);
+    mpz_clear(sum);
+
+    /* w = 1 is plain square-and-multiply; longer exponents get wider windows */
+    EXPECT_EQ(sliding_window_size(3), 1u);
+    EXPECT_LE(sliding_window_size(64), sliding_window_size(256));
+    EXPECT_LE(sliding_window_size(256), 8u);
+    for (size_t w = 1; w <= 8; w++)
+    {
+        EXPECT_LE(sliding_window_cost(256, sliding_window_size(256)), sliding_window_cost(256, w));
+    }
+}
+
+TEST(FieldUtilsTest, ChaCha20RngTest)
+{
+    /* RFC 8439, A.1, test vectors #1 and #2: all-zero key and nonce, blocks 0 and 1 */
+    const unsigned char expected[2][16] = {
+        { 0x76, 0xb8, 0xe0, 0xad, 0xa0, 0xf1, 0x3d, 0x90, 0x40, 0x5d, 0x6a, 0xe5, 0x53, 0x86, 0xbd, 0x28 },
+        { 0x9f, 0x07, 0xe7, 0xbe, 0x55, 0x51, 0x38, 0x7a, 0x98, 0xba, 0x97, 0x7c, 0x73, 0x2d, 0x08, 0x0d } };
+    chacha20_rng rng(0);
+    unsigned char stream[128];
+    rng.fill(stream, 3);
+    rng.fill(stream + 3, sizeof(stream) - 3);
+    EXPECT_EQ(memcmp(stream, expected[0], 16), 0);
+    EXPECT_EQ(memcmp(stream + 64, expected[1], 16), 0);
+
+    /* seeding restarts the stream */
+    rng.seed(0);
+    EXPECT_EQ(rng.next_word(), ((uint64_t*)stream)[0]);
+
+    thread_rng().seed(12345);
+    bigint<3> x, y;
+    x.randomize();
+    thread_rng().seed(12345);
+    y.randomize();
+    EXPECT_EQ(x, y);
+    y.randomize();
+    EXPECT_NE(x, y);
+    thread_rng().reseed();
+}
+
+/* the next word of thread_rng() in a forked child */
+static uint64_t next_word_in_child()
+{
+    int fds[2];
+    EXPECT_EQ(pipe(fds), 0);
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+        const uint64_t word = thread_rng().next_word();
+        _exit(write(fds[1], &word, sizeof(word)) == sizeof(word) ? 0 : 1);
+    }
+    uint64_t word = 0;
+    EXPECT_EQ(read(fds[0], &word, sizeof(word)), (ssize_t)sizeof(word));
+    int status;
+    waitpid(pid, &status, 0);
+    close(fds[0]);
+    close(fds[1]);
+    return word;
+}
+
+TEST(FieldUtilsTest, ChaCha20RngForkTest)
+{
+    /* a random_device key is replaced in the child */
+    thread_rng().reseed();
+    thread_rng().next_word();
+    const uint64_t child_word = next_word_in_child();
+    EXPECT_NE(child_word, thread_rng().next_word());
+
+    /* an explicitly seeded stream carries on in the child */
+    thread_rng().seed(12345);
+    thread_rng().next_word();
+    const uint64_t seeded_child_word = next_word_in_child();
+    EXPECT_EQ(seeded_child_word, thread_rng().next_word());
+    thread_rng().reseed();
+}
+
+TEST(FieldUtilsTest, Sha512MultiTest)
+{
+    /* SHA-512 of the 16 bytes (idx, iter), as computed by Python's hashlib */
+    const uint64_t idx[4] = { 0, 1, 12345, 0xffffffffffffffffull };
+    const uint64_t iter[4] = { 0, 0, 7, 3 };
+    const uint64_t expected[4][8] = {
+        { 0xf4e7df38c8ba6c0bull, 0x82c20ef00dbda17eull, 0x076121c91055f4fdull, 0x4d0c393540b8cf2cull,
+          0xa1ea54b9c3d943a7ull, 0xcc231b86c96ff8b0ull, 0xc6112c23ab67866cull, 0x273f8c5cbb2e4386ull },
+        { 0x21b8a7b7a7e9ce6full, 0x287937823cc041d2ull, 0xa4788ca0e78268bcull, 0xc5cd20a2bf991122ull,
+          0x3361ee1830271252ull, 0x08ced1b83b29c817ull, 0x6ae0948e5017e0d1ull, 0x34ccc7994c735ab8ull },
+        { 0xae43cdb5969df805ull, 0x3ecbfbc437d0435eull, 0xf9e873ba6d949449ull, 0x65a16036d3003ce8ull,
+          0x12a13eb00865d84aull, 0x44cd5d4d1a81c1fcull, 0x21f074b5e1d16d4cull, 0x2fa7d7aaa7999d8cull },
+        { 0x1aa36c98c71c30bdull, 0x410b635706fcdf0cull, 0xa84995617f5f0f4eull, 0x3aee5f25b5f36410ull,
+          0xd46fc32027d38fe2ull, 0x1abd75d15c2b0a71ull, 0x1e36c727c40e2ff6ull, 0x643567e77ea4a1c2ull } };
+
+    /* 11 messages, so the 4- and 8-lane kernels also hash a padded tail */
+    const size_t count = 11;
+    uint64_t msg_idx[count], msg_iter[count], digests[8 * count];
+    for (size_t i = 0; i < count; i++)
+    {
+        msg_idx[i] = idx[i % 4];
+        msg_iter[i] = iter[i % 4];
+    }
+
+    const size_t max_lanes = sha512_multi_lanes;
+    for (size_t lanes = 1; lanes <= max_lanes; lanes *= 2)
+    {
+        sha512_multi_lanes = lanes;
+        sha512_index_digests(digests, msg_idx, msg_iter, count);
+        for (size_t i = 0; i < count; i++)
+        {
+            for (size_t k = 0; k < 8; k++)
+            {
+                EXPECT_EQ(digests[8*i + k], expected[i % 4][k]);
+            }
+        }
+    }
+    sha512_multi_lanes = max_lanes;
+}
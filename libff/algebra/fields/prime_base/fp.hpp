@@ -10,6 +10,8 @@
 #ifndef FP_HPP_
 #define FP_HPP_
 
+#include <type_traits>
+
 #include <libff/algebra/field_utils/algorithms.hpp>
 #include <libff/algebra/field_utils/bigint.hpp>
 
@@ -18,9 +20,55 @@ namespace libff {
 template<mp_size_t n, const bigint<n>& modulus>
 class Fp_model;
 
+template<mp_size_t n, const bigint<n>& modulus>
+class Fp_wide_model;
+
 template<mp_size_t n, const bigint<n>& modulus>
 std::ostream& operator<<(std::ostream &, const Fp_model<n, modulus>&);
 
+/**
+ * Compile-time parameters of F[p].
+ *
+ * The statics of Fp_model (inv, Rsquared, ...) are set at runtime by the
+ * init_*_fields() functions, so the compiler has to load them from memory.
+ * A curve can specialize Fp_params for its modulus, with is_constexpr = true
+ * and constexpr copies of the modulus limbs and of the Montgomery constant,
+ * named as in Fp_model:
+ *
+ *   modulus[n], inv
+ *
+ * (see alt_bn128_fields.hpp). The portable arithmetic of Fp_model, used
+ * where there is no assembly for n, then works on these constants, so that
+ * it can be unrolled and specialized for the modulus. The runtime statics
+ * are still set as before and must have the same values.
+ */
+template<mp_size_t n, const bigint<n>& modulus>
+struct Fp_params {
+    static constexpr bool is_constexpr = false;
+};
+
+/**
+ * Whether Fp_model<n, modulus> keeps its elements in the redundant range
+ * [0, 2p) instead of [0, p). This is the case when compiled with
+ * REDUNDANT_FP, for moduli that have constexpr Fp_params and at least two
+ * spare bits (4p < R).
+ *
+ * With 4p < R, the Montgomery product of two representatives below 2p is
+ * again below 2p, so multiplication and squaring skip the final
+ * subtraction, and addition and subtraction reduce by 2p without branches.
+ * Equality, is_zero(), as_bigint(), inversion, the Legendre symbol and
+ * serialization work on canonical_mont_repr(); code that reads mont_repr
+ * directly must do the same.
+ */
+template<mp_size_t n, const bigint<n>& modulus, bool = Fp_params<n, modulus>::is_constexpr>
+struct Fp_is_redundant : std::false_type {};
+
+#ifdef REDUNDANT_FP
+template<mp_size_t n, const bigint<n>& modulus>
+struct Fp_is_redundant<n, modulus, true>
+    : std::integral_constant<bool, (Fp_params<n, modulus>::modulus[n-1] >> (GMP_NUMB_BITS - 2)) == 0> {};
+#endif
+
 template<mp_size_t n, const bigint<n>& modulus>
 std::istream& operator>>(std::istream &, Fp_model<n, modulus> &);
 
@@ -31,9 +79,9 @@ std::istream& operator>>(std::istream &, Fp_model<n, modulus> &);
  * of words. It is optimized for tight memory consumption, so the modulus p is
  * passed as a template parameter, to avoid per-element overheads.
  *
- * The implementation is mostly a wrapper around GMP's MPN (constant-size integers).
- * But for the integer sizes of interest for libff (3 to 5 limbs of 64 bits each),
- * we implement performance-critical routines, like addition and multiplication,
+ * The implementation works on fixed-width limb arrays (see limbs.hpp). For the
+ * integer sizes of interest for libff (3 to 6 limbs of 64 bits each), we
+ * implement performance-critical routines, like addition and multiplication,
  * using hand-optimzied assembly code.
  */
 template<mp_size_t n, const bigint<n>& modulus>
@@ -62,6 +110,8 @@ public:
     static mp_limb_t inv; // modulus^(-1) mod W, where W = 2^(word size)
     static bigint<n> Rsquared; // R^2, where R = W^k, where k = ??
     static bigint<n> Rcubed;   // R^3
+    static const std::size_t sqrt_table_min_s = 16; // sqrt() uses sqrt_table from this 2-adicity on
+    static constexpr bool is_redundant = Fp_is_redundant<n, modulus>::value; // mont_repr in [0, 2p), see Fp_is_redundant
 
     Fp_model() {};
     Fp_model(const bigint<n> &b);
@@ -90,6 +140,12 @@ public:
      */
     bool from_words(std::vector<uint64_t> words);
 
+    /**
+     * Returns mont_repr reduced to [0, p). Unless is_redundant, this is
+     * mont_repr itself.
+     */
+    bigint<n> canonical_mont_repr() const;
+
     /* Return the standard (not Montgomery) representation of the
        Field element's requivalence class. I.e. Fp(2).as_bigint()
         would return bigint(2) */
@@ -120,10 +176,28 @@ public:
 
     Fp_model& square();
     Fp_model squared() const;
+    /**
+     * Products without the Montgomery reduction step. The results can be
+     * added and subtracted in double width, and brought back to the field
+     * with a single Fp_wide_model::reduce().
+     */
+    Fp_wide_model<n, modulus> mul_unreduced(const Fp_model& other) const;
+    Fp_wide_model<n, modulus> squared_unreduced() const;
     Fp_model& invert();
     Fp_model inverse() const;
+    /**
+     * Inversion by safegcd_inverse, whose running time does not depend on
+     * the value. About twice as slow as invert(), which goes through GMP's
+     * variable-time gcdext, so only use it for secret values.
+     */
+    Fp_model& invert_constant_time();
+    Fp_model inverse_constant_time() const;
     Fp_model Frobenius_map(unsigned long power) const;
-    Fp_model sqrt() const; // HAS TO BE A SQUARE (else does not terminate)
+    Fp_model sqrt() const; // HAS TO BE A SQUARE (else does not terminate, or is wrong if p = 3 mod 4)
+    /** Legendre symbol: 1 for non-zero squares, -1 for non-squares and 0 for zero. */
+    int legendre() const;
+    /** Whether sqrt() can be called, i.e. legendre() != -1. */
+    bool is_square() const;
 
     static std::size_t ceil_size_in_bits() { return num_bits; }
     static std::size_t floor_size_in_bits() { return num_bits - 1; }
@@ -144,8 +218,122 @@ public:
 private:
     /** Returns a representation in bigint, depending on the MONTGOMERY_OUTPUT flag. */
     bigint<n> bigint_repr() const;
+
+    /*
+      Arithmetic for when there is no assembly for n: on the constants of
+      Fp_params for std::true_type, on the limbs of modulus otherwise.
+     */
+    typedef std::integral_constant<bool, Fp_params<n, modulus>::is_constexpr> has_constexpr_params;
+    void mul_reduce_portable(const bigint<n> &other, std::true_type);
+    void mul_reduce_portable(const bigint<n> &other, std::false_type);
+    void add_portable(const Fp_model &other, std::true_type);
+    void add_portable(const Fp_model &other, std::false_type);
+    void sub_portable(const Fp_model &other, std::true_type);
+    void sub_portable(const Fp_model &other, std::false_type);
+
+    /*
+      The double-limb code behind both overloads, with the modulus limbs
+      supplied by M: constexpr_modulus reads Fp_params, runtime_modulus
+      reads modulus.
+     */
+    template<typename M> void mul_reduce_limbs(const bigint<n> &other);
+    template<typename M> void add_limbs(const Fp_model &other);
+    template<typename M> void sub_limbs(const Fp_model &other);
+
+    struct constexpr_modulus
+    {
+        static constexpr mp_limb_t limb(const std::size_t j) { return Fp_params<n, modulus>::modulus[j]; }
+        static constexpr mp_limb_t double_limb(const std::size_t j) { return double_modulus_limb(j); }
+        static constexpr mp_limb_t inv() { return Fp_params<n, modulus>::inv; }
+    };
+
+    struct runtime_modulus
+    {
+        static mp_limb_t limb(const std::size_t j) { return modulus.data[j]; }
+        static mp_limb_t double_limb(const std::size_t j) { return double_modulus().data[j]; }
+        static mp_limb_t inv() { return Fp_model::inv; }
+    };
+
+    /*
+      Addition and subtraction for is_redundant, which reduce by 2p without
+      branches: in assembly for 4 and 6 limbs, with the portable code
+      otherwise.
+     */
+    void add_redundant(const Fp_model &other);
+    void sub_redundant(const Fp_model &other);
+    static const bigint<n>& double_modulus();
+
+    /** Limb j of 2p, for the redundant representation (needs constexpr Fp_params). */
+    static constexpr mp_limb_t double_modulus_limb(const std::size_t j)
+    {
+        return (Fp_params<n, modulus>::modulus[j] << 1)
+            | (j == 0 ? 0 : Fp_params<n, modulus>::modulus[j-1] >> (GMP_NUMB_BITS - 1));
+    }
 };
 
+/**
+ * Double-width element used for lazy reduction.
+ *
+ * The product of two Montgomery representatives xR and yR is xyR^2, which
+ * one Montgomery reduction maps back to xyR. Sums and differences of such
+ * products can therefore be accumulated in 2n limbs and reduced once, which
+ * saves a reduction per term in extension field arithmetic.
+ *
+ * The representative is kept in [0, p*R), i.e. its upper n limbs are always
+ * less than the modulus. Addition and subtraction correct by p*R as needed,
+ * so any number of them may be chained before reduce().
+ */
+template<mp_size_t n, const bigint<n>& modulus>
+class Fp_wide_model {
+public:
+    bigint<2*n> repr;
+
+    Fp_wide_model() {};
+
+    Fp_wide_model& operator+=(const Fp_wide_model& other);
+    Fp_wide_model& operator-=(const Fp_wide_model& other);
+    Fp_wide_model operator+(const Fp_wide_model& other) const;
+    Fp_wide_model operator-(const Fp_wide_model& other) const;
+
+    /** Performs montgomery_reduce(repr), returning an element of the base field. */
+    Fp_model<n, modulus> reduce() const;
+
+    static Fp_wide_model<n, modulus> zero();
+};
+
+/**
+ * Elementwise vector multiplication for prime fields, overloading the
+ * generic versions in field_utils.hpp. For 4-limb fields, when the CPU
+ * supports it (see use_avx512_ifma), the elements are processed eight at a
+ * time in a sliced 52-bit representation with AVX-512 IFMA; otherwise these
+ * fall back to the scalar operators.
+ */
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_mul(std::vector<Fp_model<n, modulus> > &vec, const std::vector<Fp_model<n, modulus> > &other);
+
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_square(std::vector<Fp_model<n, modulus> > &vec);
+
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_mul_scalar(std::vector<Fp_model<n, modulus> > &vec, const Fp_model<n, modulus> &c);
+
+/** Legendre symbols of all elements of vec, see Fp_model::legendre(). */
+template<mp_size_t n, const bigint<n>& modulus>
+std::vector<int> batch_legendre(const std::vector<Fp_model<n, modulus> > &vec);
+
+/**
+ * Bulk conversions out of and into Montgomery form, writing count elements
+ * to the caller's array result, which must not overlap the input:
+ * to_bigints sets result[i] = elements[i].as_bigint() and from_bigints sets
+ * result[i] = Fp_model(values[i]). The arrays are converted in chunks, in
+ * parallel under MULTICORE, and with AVX-512 IFMA as for batch_mul.
+ */
+template<mp_size_t n, const bigint<n>& modulus>
+void to_bigints(const Fp_model<n, modulus> *elements, const std::size_t count, bigint<n> *result);
+
+template<mp_size_t n, const bigint<n>& modulus>
+void from_bigints(const bigint<n> *values, const std::size_t count, Fp_model<n, modulus> *result);
+
 #ifdef PROFILE_OP_COUNTS
 template<mp_size_t n, const bigint<n>& modulus>
 long long Fp_model<n, modulus>::add_cnt = 0;
@@ -163,6 +351,9 @@ template<mp_size_t n, const bigint<n>& modulus>
 long long Fp_model<n, modulus>::inv_cnt = 0;
 #endif
 
+template<mp_size_t n, const bigint<n>& modulus>
+constexpr bool Fp_model<n, modulus>::is_redundant;
+
 template<mp_size_t n, const bigint<n>& modulus>
 size_t Fp_model<n, modulus>::num_bits;
 
@@ -9,6 +9,7 @@
 
 #ifndef FP_TCC_
 #define FP_TCC_
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
@@ -17,6 +18,10 @@
 
 #include <libff/algebra/field_utils/field_utils.hpp>
 #include <libff/algebra/field_utils/fp_aux.tcc>
+#include <libff/algebra/fields/prime_base/fp_ifma.hpp>
+
+/* the loops of the arithmetic on Fp_params are meant to be unrolled for each field */
+#define FP_UNROLL _Pragma("GCC unroll 16")
 
 namespace libff {
 
@@ -27,7 +32,332 @@ void Fp_model<n,modulus>::mul_reduce(const bigint<n> &other)
 {
     /* stupid pre-processor tricks; beware */
 #if defined(__x86_64__) && defined(USE_ASM)
-    if (n == 3)
+    if (n == 4 && use_mulx_adx)
+    { // use mulx/adcx/adox-based Montgomery multiplication
+
+        mp_limb_t t0, t1, t2, t3, t4, hi;
+
+        __asm__ (MULX_FIRSTROUND_BEGIN(t0, t1)
+                 MULX_FIRSTROUND_STEP(1, t1, t2)
+                 MULX_FIRSTROUND_STEP(2, t2, t3)
+                 MULX_FIRSTROUND_STEP(3, t3, t4)
+                 MULX_FIRSTROUND_END(t4)
+                 MULX_REDUCE_BEGIN(t0)
+                 MULX_REDUCE_STEP(0, t0, t1)
+                 MULX_REDUCE_STEP(1, t1, t2)
+                 MULX_REDUCE_STEP(2, t2, t3)
+                 MULX_REDUCE_STEP(3, t3, t4)
+                 MULX_CARRY(t4)
+                 MULX_ROUND_BEGIN(1)
+                 MULX_MUL_STEP(0, t1, t2)
+                 MULX_MUL_STEP(1, t2, t3)
+                 MULX_MUL_STEP(2, t3, t4)
+                 MULX_MUL_STEP(3, t4, t0)
+                 MULX_CARRY(t0)
+                 MULX_REDUCE_BEGIN(t1)
+                 MULX_REDUCE_STEP(0, t1, t2)
+                 MULX_REDUCE_STEP(1, t2, t3)
+                 MULX_REDUCE_STEP(2, t3, t4)
+                 MULX_REDUCE_STEP(3, t4, t0)
+                 MULX_CARRY(t0)
+                 MULX_ROUND_BEGIN(2)
+                 MULX_MUL_STEP(0, t2, t3)
+                 MULX_MUL_STEP(1, t3, t4)
+                 MULX_MUL_STEP(2, t4, t0)
+                 MULX_MUL_STEP(3, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_REDUCE_BEGIN(t2)
+                 MULX_REDUCE_STEP(0, t2, t3)
+                 MULX_REDUCE_STEP(1, t3, t4)
+                 MULX_REDUCE_STEP(2, t4, t0)
+                 MULX_REDUCE_STEP(3, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_ROUND_BEGIN(3)
+                 MULX_MUL_STEP(0, t3, t4)
+                 MULX_MUL_STEP(1, t4, t0)
+                 MULX_MUL_STEP(2, t0, t1)
+                 MULX_MUL_STEP(3, t1, t2)
+                 MULX_CARRY(t2)
+                 MULX_REDUCE_BEGIN(t3)
+                 MULX_REDUCE_STEP(0, t3, t4)
+                 MULX_REDUCE_STEP(1, t4, t0)
+                 MULX_REDUCE_STEP(2, t0, t1)
+                 MULX_REDUCE_STEP(3, t1, t2)
+                 MULX_CARRY(t2)
+                 : [t0] "=&r" (t0), [t1] "=&r" (t1), [t2] "=&r" (t2), [t3] "=&r" (t3),
+                   [t4] "=&r" (t4),
+                   [hi] "=&r" (hi)
+                 : [A] "r" (this->mont_repr.data), [B] "r" (other.data), [inv] "rm" (inv), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax", "%rdx"
+        );
+        mp_limb_t tmp[4] = { t4, t0, t1, t2 };
+
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(24)
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
+
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 MONT_NEXTSUB(24)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (tmp), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
+        limbs_copy<n>(this->mont_repr.data, tmp);
+    }
+    else if (n == 5 && use_mulx_adx)
+    { // use mulx/adcx/adox-based Montgomery multiplication
+
+        mp_limb_t t0, t1, t2, t3, t4, t5, hi;
+
+        __asm__ (MULX_FIRSTROUND_BEGIN(t0, t1)
+                 MULX_FIRSTROUND_STEP(1, t1, t2)
+                 MULX_FIRSTROUND_STEP(2, t2, t3)
+                 MULX_FIRSTROUND_STEP(3, t3, t4)
+                 MULX_FIRSTROUND_STEP(4, t4, t5)
+                 MULX_FIRSTROUND_END(t5)
+                 MULX_REDUCE_BEGIN(t0)
+                 MULX_REDUCE_STEP(0, t0, t1)
+                 MULX_REDUCE_STEP(1, t1, t2)
+                 MULX_REDUCE_STEP(2, t2, t3)
+                 MULX_REDUCE_STEP(3, t3, t4)
+                 MULX_REDUCE_STEP(4, t4, t5)
+                 MULX_CARRY(t5)
+                 MULX_ROUND_BEGIN(1)
+                 MULX_MUL_STEP(0, t1, t2)
+                 MULX_MUL_STEP(1, t2, t3)
+                 MULX_MUL_STEP(2, t3, t4)
+                 MULX_MUL_STEP(3, t4, t5)
+                 MULX_MUL_STEP(4, t5, t0)
+                 MULX_CARRY(t0)
+                 MULX_REDUCE_BEGIN(t1)
+                 MULX_REDUCE_STEP(0, t1, t2)
+                 MULX_REDUCE_STEP(1, t2, t3)
+                 MULX_REDUCE_STEP(2, t3, t4)
+                 MULX_REDUCE_STEP(3, t4, t5)
+                 MULX_REDUCE_STEP(4, t5, t0)
+                 MULX_CARRY(t0)
+                 MULX_ROUND_BEGIN(2)
+                 MULX_MUL_STEP(0, t2, t3)
+                 MULX_MUL_STEP(1, t3, t4)
+                 MULX_MUL_STEP(2, t4, t5)
+                 MULX_MUL_STEP(3, t5, t0)
+                 MULX_MUL_STEP(4, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_REDUCE_BEGIN(t2)
+                 MULX_REDUCE_STEP(0, t2, t3)
+                 MULX_REDUCE_STEP(1, t3, t4)
+                 MULX_REDUCE_STEP(2, t4, t5)
+                 MULX_REDUCE_STEP(3, t5, t0)
+                 MULX_REDUCE_STEP(4, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_ROUND_BEGIN(3)
+                 MULX_MUL_STEP(0, t3, t4)
+                 MULX_MUL_STEP(1, t4, t5)
+                 MULX_MUL_STEP(2, t5, t0)
+                 MULX_MUL_STEP(3, t0, t1)
+                 MULX_MUL_STEP(4, t1, t2)
+                 MULX_CARRY(t2)
+                 MULX_REDUCE_BEGIN(t3)
+                 MULX_REDUCE_STEP(0, t3, t4)
+                 MULX_REDUCE_STEP(1, t4, t5)
+                 MULX_REDUCE_STEP(2, t5, t0)
+                 MULX_REDUCE_STEP(3, t0, t1)
+                 MULX_REDUCE_STEP(4, t1, t2)
+                 MULX_CARRY(t2)
+                 MULX_ROUND_BEGIN(4)
+                 MULX_MUL_STEP(0, t4, t5)
+                 MULX_MUL_STEP(1, t5, t0)
+                 MULX_MUL_STEP(2, t0, t1)
+                 MULX_MUL_STEP(3, t1, t2)
+                 MULX_MUL_STEP(4, t2, t3)
+                 MULX_CARRY(t3)
+                 MULX_REDUCE_BEGIN(t4)
+                 MULX_REDUCE_STEP(0, t4, t5)
+                 MULX_REDUCE_STEP(1, t5, t0)
+                 MULX_REDUCE_STEP(2, t0, t1)
+                 MULX_REDUCE_STEP(3, t1, t2)
+                 MULX_REDUCE_STEP(4, t2, t3)
+                 MULX_CARRY(t3)
+                 : [t0] "=&r" (t0), [t1] "=&r" (t1), [t2] "=&r" (t2), [t3] "=&r" (t3),
+                   [t4] "=&r" (t4), [t5] "=&r" (t5),
+                   [hi] "=&r" (hi)
+                 : [A] "r" (this->mont_repr.data), [B] "r" (other.data), [inv] "rm" (inv), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax", "%rdx"
+        );
+        mp_limb_t tmp[5] = { t5, t0, t1, t2, t3 };
+
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(32)
+                 MONT_CMP(24)
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
+
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 MONT_NEXTSUB(24)
+                 MONT_NEXTSUB(32)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (tmp), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
+        limbs_copy<n>(this->mont_repr.data, tmp);
+    }
+    else if (n == 6 && use_mulx_adx)
+    { // use mulx/adcx/adox-based Montgomery multiplication
+
+        mp_limb_t t0, t1, t2, t3, t4, t5, t6, hi;
+
+        __asm__ (MULX_FIRSTROUND_BEGIN(t0, t1)
+                 MULX_FIRSTROUND_STEP(1, t1, t2)
+                 MULX_FIRSTROUND_STEP(2, t2, t3)
+                 MULX_FIRSTROUND_STEP(3, t3, t4)
+                 MULX_FIRSTROUND_STEP(4, t4, t5)
+                 MULX_FIRSTROUND_STEP(5, t5, t6)
+                 MULX_FIRSTROUND_END(t6)
+                 MULX_REDUCE_BEGIN(t0)
+                 MULX_REDUCE_STEP(0, t0, t1)
+                 MULX_REDUCE_STEP(1, t1, t2)
+                 MULX_REDUCE_STEP(2, t2, t3)
+                 MULX_REDUCE_STEP(3, t3, t4)
+                 MULX_REDUCE_STEP(4, t4, t5)
+                 MULX_REDUCE_STEP(5, t5, t6)
+                 MULX_CARRY(t6)
+                 MULX_ROUND_BEGIN(1)
+                 MULX_MUL_STEP(0, t1, t2)
+                 MULX_MUL_STEP(1, t2, t3)
+                 MULX_MUL_STEP(2, t3, t4)
+                 MULX_MUL_STEP(3, t4, t5)
+                 MULX_MUL_STEP(4, t5, t6)
+                 MULX_MUL_STEP(5, t6, t0)
+                 MULX_CARRY(t0)
+                 MULX_REDUCE_BEGIN(t1)
+                 MULX_REDUCE_STEP(0, t1, t2)
+                 MULX_REDUCE_STEP(1, t2, t3)
+                 MULX_REDUCE_STEP(2, t3, t4)
+                 MULX_REDUCE_STEP(3, t4, t5)
+                 MULX_REDUCE_STEP(4, t5, t6)
+                 MULX_REDUCE_STEP(5, t6, t0)
+                 MULX_CARRY(t0)
+                 MULX_ROUND_BEGIN(2)
+                 MULX_MUL_STEP(0, t2, t3)
+                 MULX_MUL_STEP(1, t3, t4)
+                 MULX_MUL_STEP(2, t4, t5)
+                 MULX_MUL_STEP(3, t5, t6)
+                 MULX_MUL_STEP(4, t6, t0)
+                 MULX_MUL_STEP(5, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_REDUCE_BEGIN(t2)
+                 MULX_REDUCE_STEP(0, t2, t3)
+                 MULX_REDUCE_STEP(1, t3, t4)
+                 MULX_REDUCE_STEP(2, t4, t5)
+                 MULX_REDUCE_STEP(3, t5, t6)
+                 MULX_REDUCE_STEP(4, t6, t0)
+                 MULX_REDUCE_STEP(5, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_ROUND_BEGIN(3)
+                 MULX_MUL_STEP(0, t3, t4)
+                 MULX_MUL_STEP(1, t4, t5)
+                 MULX_MUL_STEP(2, t5, t6)
+                 MULX_MUL_STEP(3, t6, t0)
+                 MULX_MUL_STEP(4, t0, t1)
+                 MULX_MUL_STEP(5, t1, t2)
+                 MULX_CARRY(t2)
+                 MULX_REDUCE_BEGIN(t3)
+                 MULX_REDUCE_STEP(0, t3, t4)
+                 MULX_REDUCE_STEP(1, t4, t5)
+                 MULX_REDUCE_STEP(2, t5, t6)
+                 MULX_REDUCE_STEP(3, t6, t0)
+                 MULX_REDUCE_STEP(4, t0, t1)
+                 MULX_REDUCE_STEP(5, t1, t2)
+                 MULX_CARRY(t2)
+                 MULX_ROUND_BEGIN(4)
+                 MULX_MUL_STEP(0, t4, t5)
+                 MULX_MUL_STEP(1, t5, t6)
+                 MULX_MUL_STEP(2, t6, t0)
+                 MULX_MUL_STEP(3, t0, t1)
+                 MULX_MUL_STEP(4, t1, t2)
+                 MULX_MUL_STEP(5, t2, t3)
+                 MULX_CARRY(t3)
+                 MULX_REDUCE_BEGIN(t4)
+                 MULX_REDUCE_STEP(0, t4, t5)
+                 MULX_REDUCE_STEP(1, t5, t6)
+                 MULX_REDUCE_STEP(2, t6, t0)
+                 MULX_REDUCE_STEP(3, t0, t1)
+                 MULX_REDUCE_STEP(4, t1, t2)
+                 MULX_REDUCE_STEP(5, t2, t3)
+                 MULX_CARRY(t3)
+                 MULX_ROUND_BEGIN(5)
+                 MULX_MUL_STEP(0, t5, t6)
+                 MULX_MUL_STEP(1, t6, t0)
+                 MULX_MUL_STEP(2, t0, t1)
+                 MULX_MUL_STEP(3, t1, t2)
+                 MULX_MUL_STEP(4, t2, t3)
+                 MULX_MUL_STEP(5, t3, t4)
+                 MULX_CARRY(t4)
+                 MULX_REDUCE_BEGIN(t5)
+                 MULX_REDUCE_STEP(0, t5, t6)
+                 MULX_REDUCE_STEP(1, t6, t0)
+                 MULX_REDUCE_STEP(2, t0, t1)
+                 MULX_REDUCE_STEP(3, t1, t2)
+                 MULX_REDUCE_STEP(4, t2, t3)
+                 MULX_REDUCE_STEP(5, t3, t4)
+                 MULX_CARRY(t4)
+                 : [t0] "=&r" (t0), [t1] "=&r" (t1), [t2] "=&r" (t2), [t3] "=&r" (t3),
+                   [t4] "=&r" (t4), [t5] "=&r" (t5), [t6] "=&r" (t6),
+                   [hi] "=&r" (hi)
+                 : [A] "r" (this->mont_repr.data), [B] "r" (other.data), [inv] "rm" (inv), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax", "%rdx"
+        );
+        mp_limb_t tmp[6] = { t6, t0, t1, t2, t3, t4 };
+
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(40)
+                 MONT_CMP(32)
+                 MONT_CMP(24)
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
+
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 MONT_NEXTSUB(24)
+                 MONT_NEXTSUB(32)
+                 MONT_NEXTSUB(40)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (tmp), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
+        limbs_copy<n>(this->mont_repr.data, tmp);
+    }
+    else if (n == 3)
     { // Use asm-optimized Comba multiplication and reduction
         mp_limb_t res[2*n];
         mp_limb_t c0, c1, c2;
@@ -37,23 +367,26 @@ void Fp_model<n,modulus>::mul_reduce(const bigint<n> &other)
         mp_limb_t tmp1, tmp2, tmp3;
         REDUCE_6_LIMB_PRODUCT(k, tmp1, tmp2, tmp3, inv, res, modulus.data);
 
-        /* subtract t > mod */
-        __asm__
-            ("/* check for overflow */        \n\t"
-             MONT_CMP(16)
-             MONT_CMP(8)
-             MONT_CMP(0)
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
 
-             "/* subtract mod if overflow */  \n\t"
-             "subtract%=:                     \n\t"
-             MONT_FIRSTSUB
-             MONT_NEXTSUB(8)
-             MONT_NEXTSUB(16)
-             "done%=:                         \n\t"
-             :
-             : [tmp] "r" (res+n), [M] "r" (modulus.data)
-             : "cc", "memory", "%rax");
-        mpn_copyi(this->mont_repr.data, res+n, n);
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (res+n), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
+        limbs_copy<n>(this->mont_repr.data, res+n);
     }
     else if (n == 4)
     { // use asm-optimized "CIOS method"
@@ -99,7 +432,7 @@ void Fp_model<n,modulus>::mul_reduce(const bigint<n> &other)
                    [T0] "r" (T0), [T1] "r" (T1), [cy] "r" (cy), [u] "r" (u)
                  : "cc", "memory", "%rax", "%rdx"
         );
-        mpn_copyi(this->mont_repr.data, tmp, n);
+        limbs_copy<n>(this->mont_repr.data, tmp);
     }
     else if (n == 5)
     { // use asm-optimized "CIOS method"
@@ -157,46 +490,134 @@ void Fp_model<n,modulus>::mul_reduce(const bigint<n> &other)
                    [T0] "r" (T0), [T1] "r" (T1), [cy] "r" (cy), [u] "r" (u)
                  : "cc", "memory", "%rax", "%rdx"
         );
-        mpn_copyi(this->mont_repr.data, tmp, n);
+        limbs_copy<n>(this->mont_repr.data, tmp);
+    }
+    else if (n == 6)
+    { // use asm-optimized Comba multiplication, followed by a separate reduction
+        mp_limb_t res[2*n];
+        mp_limb_t c0, c1, c2;
+        COMBA_6_BY_6_MUL(c0, c1, c2, res, this->mont_repr.data, other.data);
+
+        mp_limb_t k, hi, cy;
+        REDUCE_12_LIMB_PRODUCT(k, hi, cy, inv, res, modulus.data);
+
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(40)
+                 MONT_CMP(32)
+                 MONT_CMP(24)
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
+
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 MONT_NEXTSUB(24)
+                 MONT_NEXTSUB(32)
+                 MONT_NEXTSUB(40)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (res+n), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
+        limbs_copy<n>(this->mont_repr.data, res+n);
     }
     else
 #endif
     {
-        mp_limb_t res[2*n];
-        mpn_mul_n(res, this->mont_repr.data, other.data, n);
+        mul_reduce_portable(other, has_constexpr_params());
+    }
+}
 
-        /*
-          The Montgomery reduction here is based on Algorithm 14.32 in
-          Handbook of Applied Cryptography
-          <http://cacr.uwaterloo.ca/hac/about/chap14.pdf>.
-         */
-        for (size_t i = 0; i < n; ++i)
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::mul_reduce_portable(const bigint<n> &other, std::true_type)
+{
+    mul_reduce_limbs<constexpr_modulus>(other);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+template<typename M>
+void Fp_model<n,modulus>::mul_reduce_limbs(const bigint<n> &other)
+{
+    /* if the top bit of the modulus is clear, the running sum never exceeds n+1 limbs */
+    const bool spare_bit = (M::limb(n-1) >> (GMP_NUMB_BITS - 1)) == 0;
+
+    /* CIOS Montgomery multiplication; for constexpr_modulus, M::limb and M::inv are compile-time constants */
+    mp_limb_t t[n+2] = {0};
+    FP_UNROLL
+    for (size_t i = 0; i < n; ++i)
+    {
+        dlimb_t c = 0;
+        FP_UNROLL
+        for (size_t j = 0; j < n; ++j)
         {
-            mp_limb_t k = inv * res[i];
-            /* calculate res = res + k * mod * b^i */
-            mp_limb_t carryout = mpn_addmul_1(res+i, modulus.data, n, k);
-            carryout = mpn_add_1(res+n+i, res+n+i, n-i, carryout);
-            assert(carryout == 0);
+            c += (dlimb_t)this->mont_repr.data[j] * other.data[i] + t[j];
+            t[j] = (mp_limb_t)c;
+            c >>= GMP_NUMB_BITS;
+        }
+        c += t[n];
+        t[n] = (mp_limb_t)c;
+        t[n+1] = spare_bit ? 0 : (mp_limb_t)(c >> GMP_NUMB_BITS);
+
+        const mp_limb_t k = t[0] * M::inv();
+        c = ((dlimb_t)k * M::limb(0) + t[0]) >> GMP_NUMB_BITS;
+        FP_UNROLL
+        for (size_t j = 1; j < n; ++j)
+        {
+            c += (dlimb_t)k * M::limb(j) + t[j];
+            t[j-1] = (mp_limb_t)c;
+            c >>= GMP_NUMB_BITS;
         }
+        c += t[n];
+        t[n-1] = (mp_limb_t)c;
+        t[n] = t[n+1] + (mp_limb_t)(c >> GMP_NUMB_BITS);
+    }
 
-        if (mpn_cmp(res+n, modulus.data, n) >= 0)
+    if (is_redundant)
+    {
+        /* inputs below 2p < R/2 give t < 2p, which is a valid representative */
+        FP_UNROLL
+        for (size_t j = 0; j < n; ++j)
         {
-            const mp_limb_t borrow = mpn_sub(res+n, res+n, n, modulus.data, n);
-#ifndef NDEBUG
-            assert(borrow == 0);
-#else
-            UNUSED(borrow);
-#endif
+            this->mont_repr.data[j] = t[j];
         }
+        return;
+    }
 
-        mpn_copyi(this->mont_repr.data, res+n, n);
+    /* subtract the modulus if t >= modulus */
+    mp_limb_t d[n];
+    mp_limb_t borrow = 0;
+    FP_UNROLL
+    for (size_t j = 0; j < n; ++j)
+    {
+        const mp_limb_t x = t[j] - M::limb(j);
+        d[j] = x - borrow;
+        borrow = (mp_limb_t)(t[j] < M::limb(j)) | (mp_limb_t)(x < borrow);
     }
+    const mp_limb_t *result = (t[n] != 0 || borrow == 0) ? d : t;
+    FP_UNROLL
+    for (size_t j = 0; j < n; ++j)
+    {
+        this->mont_repr.data[j] = result[j];
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::mul_reduce_portable(const bigint<n> &other, std::false_type)
+{
+    mul_reduce_limbs<runtime_modulus>(other);
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
 Fp_model<n,modulus>::Fp_model(const bigint<n> &b)
 {
-    mpn_copyi(this->mont_repr.data, Rsquared.data, n);
+    limbs_copy<n>(this->mont_repr.data, Rsquared.data);
     mul_reduce(b);
 }
 
@@ -210,7 +631,7 @@ Fp_model<n,modulus>::Fp_model(const long x, const bool is_unsigned)
     }
     else
     {
-        const mp_limb_t borrow = mpn_sub_1(this->mont_repr.data, modulus.data, n, (mp_limb_t)-x);
+        const mp_limb_t borrow = limbs_sub_1<n>(this->mont_repr.data, modulus.data, (mp_limb_t)-x);
 #ifndef NDEBUG
             assert(borrow == 0);
 #else
@@ -241,11 +662,26 @@ void Fp_model<n,modulus>::randomize()
     (*this) = Fp_model<n, modulus>::random_element();
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+bigint<n> Fp_model<n,modulus>::canonical_mont_repr() const
+{
+    if (!is_redundant)
+    {
+        return this->mont_repr;
+    }
+
+    /* mont_repr < 2p, so one conditional subtraction suffices */
+    bigint<n> r;
+    const mp_limb_t borrow = limbs_sub<n>(r.data, this->mont_repr.data, modulus.data);
+    return borrow ? this->mont_repr : r;
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 bigint<n> Fp_model<n,modulus>::as_bigint() const
 {
     bigint<n> one = bigint<n>::one();
-    Fp_model<n, modulus> res(*this);
+    Fp_model<n, modulus> res;
+    res.mont_repr = this->canonical_mont_repr();
     res.mul_reduce(one);
 
     return (res.mont_repr);
@@ -260,29 +696,33 @@ unsigned long Fp_model<n,modulus>::as_ulong() const
 template<mp_size_t n, const bigint<n>& modulus>
 bool Fp_model<n,modulus>::operator==(const Fp_model& other) const
 {
+    if (is_redundant)
+    {
+        return (this->canonical_mont_repr() == other.canonical_mont_repr());
+    }
     return (this->mont_repr == other.mont_repr);
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
 bool Fp_model<n,modulus>::operator!=(const Fp_model& other) const
 {
-    return (this->mont_repr != other.mont_repr);
+    return !(*this == other);
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
 bool Fp_model<n,modulus>::is_zero() const
 {
+    if (is_redundant)
+    {
+        return (this->mont_repr.is_zero() || this->mont_repr == modulus); // zero maps to zero or p
+    }
     return (this->mont_repr.is_zero()); // zero maps to zero
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
 void Fp_model<n,modulus>::print() const
 {
-    Fp_model<n,modulus> tmp;
-    tmp.mont_repr.data[0] = 1;
-    tmp.mul_reduce(this->mont_repr);
-
-    tmp.mont_repr.print();
+    this->as_bigint().print();
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
@@ -326,6 +766,11 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::operator+=(const Fp_model<n,modulus>&
 #ifdef PROFILE_OP_COUNTS
     this->add_cnt++;
 #endif
+    if (is_redundant)
+    {
+        add_redundant(other);
+        return *this;
+    }
 #if defined(__x86_64__) && defined(USE_ASM)
     if (n == 3)
     {
@@ -414,27 +859,95 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::operator+=(const Fp_model<n,modulus>&
              : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [mod] "r" (modulus.data)
              : "cc", "memory", "%rax");
     }
+    else if (n == 6)
+    {
+        __asm__
+            ("/* perform bignum addition */   \n\t"
+             ADD_FIRSTADD
+             ADD_NEXTADD(8)
+             ADD_NEXTADD(16)
+             ADD_NEXTADD(24)
+             ADD_NEXTADD(32)
+             ADD_NEXTADD(40)
+             "/* if overflow: subtract     */ \n\t"
+             "/* (tricky point: if A and B are in the range we do not need to do anything special for the possible carry flag) */ \n\t"
+             "jc      subtract%=              \n\t"
+
+             "/* check for overflow */        \n\t"
+             ADD_CMP(40)
+             ADD_CMP(32)
+             ADD_CMP(24)
+             ADD_CMP(16)
+             ADD_CMP(8)
+             ADD_CMP(0)
+
+             "/* subtract mod if overflow */  \n\t"
+             "subtract%=:                     \n\t"
+             ADD_FIRSTSUB
+             ADD_NEXTSUB(8)
+             ADD_NEXTSUB(16)
+             ADD_NEXTSUB(24)
+             ADD_NEXTSUB(32)
+             ADD_NEXTSUB(40)
+             "done%=:                         \n\t"
+             :
+             : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [mod] "r" (modulus.data)
+             : "cc", "memory", "%rax");
+    }
     else
 #endif
     {
-        mp_limb_t scratch[n+1];
-        const mp_limb_t carry = mpn_add_n(scratch, this->mont_repr.data, other.mont_repr.data, n);
-        scratch[n] = carry;
+        add_portable(other, has_constexpr_params());
+    }
 
-        if (carry || mpn_cmp(scratch, modulus.data, n) >= 0)
-        {
-            const mp_limb_t borrow = mpn_sub(scratch, scratch, n+1, modulus.data, n);
-#ifndef NDEBUG
-            assert(borrow == 0);
-#else
-            UNUSED(borrow);
-#endif
-        }
+    return *this;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::add_portable(const Fp_model<n,modulus>& other, std::true_type)
+{
+    add_limbs<constexpr_modulus>(other);
+}
 
-        mpn_copyi(this->mont_repr.data, scratch, n);
+template<mp_size_t n, const bigint<n>& modulus>
+template<typename M>
+void Fp_model<n,modulus>::add_limbs(const Fp_model<n,modulus>& other)
+{
+    mp_limb_t sum[n];
+    dlimb_t c = 0;
+    FP_UNROLL
+    for (size_t j = 0; j < n; ++j)
+    {
+        c += (dlimb_t)this->mont_repr.data[j] + other.mont_repr.data[j];
+        sum[j] = (mp_limb_t)c;
+        c >>= GMP_NUMB_BITS;
     }
+    const mp_limb_t carry = (mp_limb_t)c;
 
-    return *this;
+    /* subtract the modulus (2p if is_redundant) if sum >= modulus */
+    mp_limb_t d[n];
+    mp_limb_t borrow = 0;
+    FP_UNROLL
+    for (size_t j = 0; j < n; ++j)
+    {
+        const mp_limb_t m = is_redundant ? M::double_limb(j) : M::limb(j);
+        const mp_limb_t x = sum[j] - m;
+        d[j] = x - borrow;
+        borrow = (mp_limb_t)(sum[j] < m) | (mp_limb_t)(x < borrow);
+    }
+    /* keep sum where the subtraction borrowed, selecting with a mask rather than a branch */
+    const mp_limb_t keep = -(borrow & (mp_limb_t)(carry == 0));
+    FP_UNROLL
+    for (size_t j = 0; j < n; ++j)
+    {
+        this->mont_repr.data[j] = (sum[j] & keep) | (d[j] & ~keep);
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::add_portable(const Fp_model<n,modulus>& other, std::false_type)
+{
+    add_limbs<runtime_modulus>(other);
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
@@ -443,6 +956,11 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::operator-=(const Fp_model<n,modulus>&
 #ifdef PROFILE_OP_COUNTS
     this->sub_cnt++;
 #endif
+    if (is_redundant)
+    {
+        sub_redundant(other);
+        return *this;
+    }
 #if defined(__x86_64__) && defined(USE_ASM)
     if (n == 3)
     {
@@ -504,54 +1022,268 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::operator-=(const Fp_model<n,modulus>&
              : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [mod] "r" (modulus.data)
              : "cc", "memory", "%rax");
     }
-    else
-#endif
+    else if (n == 6)
     {
-        mp_limb_t scratch[n+1];
-        if (mpn_cmp(this->mont_repr.data, other.mont_repr.data, n) < 0)
-        {
-            const mp_limb_t carry = mpn_add_n(scratch, this->mont_repr.data, modulus.data, n);
-            scratch[n] = carry;
-        }
-        else
-        {
-            mpn_copyi(scratch, this->mont_repr.data, n);
-            scratch[n] = 0;
-        }
+        __asm__
+            (SUB_FIRSTSUB
+             SUB_NEXTSUB(8)
+             SUB_NEXTSUB(16)
+             SUB_NEXTSUB(24)
+             SUB_NEXTSUB(32)
+             SUB_NEXTSUB(40)
 
-        const mp_limb_t borrow = mpn_sub(scratch, scratch, n+1, other.mont_repr.data, n);
-#ifndef NDEBUG
-        assert(borrow == 0);
-#else
-        UNUSED(borrow);
-#endif
+             "jnc     done%=\n\t"
+
+             SUB_FIRSTADD
+             SUB_NEXTADD(8)
+             SUB_NEXTADD(16)
+             SUB_NEXTADD(24)
+             SUB_NEXTADD(32)
+             SUB_NEXTADD(40)
 
-        mpn_copyi(this->mont_repr.data, scratch, n);
+             "done%=:\n\t"
+             :
+             : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [mod] "r" (modulus.data)
+             : "cc", "memory", "%rax");
+    }
+    else
+#endif
+    {
+        sub_portable(other, has_constexpr_params());
     }
     return *this;
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
-Fp_model<n,modulus>& Fp_model<n,modulus>::operator*=(const Fp_model<n,modulus>& other)
+void Fp_model<n,modulus>::sub_portable(const Fp_model<n,modulus>& other, std::true_type)
 {
-#ifdef PROFILE_OP_COUNTS
-    this->mul_cnt++;
-#endif
-
-    mul_reduce(other.mont_repr);
-    return *this;
+    sub_limbs<constexpr_modulus>(other);
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
-Fp_model<n,modulus>& Fp_model<n,modulus>::operator^=(const unsigned long pow)
+template<typename M>
+void Fp_model<n,modulus>::sub_limbs(const Fp_model<n,modulus>& other)
 {
-    (*this) = power<Fp_model<n, modulus> >(*this, pow);
-    return (*this);
+    mp_limb_t diff[n];
+    mp_limb_t borrow = 0;
+    FP_UNROLL
+    for (size_t j = 0; j < n; ++j)
+    {
+        const mp_limb_t a = this->mont_repr.data[j], b = other.mont_repr.data[j];
+        const mp_limb_t x = a - b;
+        diff[j] = x - borrow;
+        borrow = (mp_limb_t)(a < b) | (mp_limb_t)(x < borrow);
+    }
+
+    /* add the modulus (2p if is_redundant) back if the difference is negative */
+    const mp_limb_t mask = -borrow;
+    dlimb_t c = 0;
+    FP_UNROLL
+    for (size_t j = 0; j < n; ++j)
+    {
+        const mp_limb_t m = is_redundant ? M::double_limb(j) : M::limb(j);
+        c += (dlimb_t)diff[j] + (m & mask);
+        this->mont_repr.data[j] = (mp_limb_t)c;
+        c >>= GMP_NUMB_BITS;
+    }
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
-template<mp_size_t m>
-Fp_model<n,modulus>& Fp_model<n,modulus>::operator^=(const bigint<m> &pow)
+void Fp_model<n,modulus>::sub_portable(const Fp_model<n,modulus>& other, std::false_type)
+{
+    sub_limbs<runtime_modulus>(other);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+const bigint<n>& Fp_model<n,modulus>::double_modulus()
+{
+    static const bigint<n> result = []() {
+        bigint<n> r;
+        limbs_lshift<n>(r.data, modulus.data, 1);
+        return r;
+    }();
+    return result;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::add_redundant(const Fp_model<n,modulus>& other)
+{
+#if defined(__x86_64__) && defined(USE_ASM)
+    if (n == 4)
+    {
+        mp_limb_t r0, r1, r2, r3;
+        __asm__ volatile
+            (RADD_FIRSTADD(r0)
+             RADD_NEXTADD(8, r1)
+             RADD_NEXTADD(16, r2)
+             RADD_NEXTADD(24, r3)
+             RED_STORE(0, r0)
+             RED_STORE(8, r1)
+             RED_STORE(16, r2)
+             RED_STORE(24, r3)
+             RED_FIRSTSUB_2P(r0)
+             RED_NEXTSUB_2P(8, r1)
+             RED_NEXTSUB_2P(16, r2)
+             RED_NEXTSUB_2P(24, r3)
+             RED_CMOVC(0, r0)
+             RED_CMOVC(8, r1)
+             RED_CMOVC(16, r2)
+             RED_CMOVC(24, r3)
+             RED_STORE(0, r0)
+             RED_STORE(8, r1)
+             RED_STORE(16, r2)
+             RED_STORE(24, r3)
+             : [r0] "=&r" (r0), [r1] "=&r" (r1), [r2] "=&r" (r2), [r3] "=&r" (r3)
+             : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [D] "r" (double_modulus().data)
+             : "cc", "memory");
+    }
+    else if (n == 6)
+    {
+        mp_limb_t r0, r1, r2, r3, r4, r5;
+        __asm__ volatile
+            (RADD_FIRSTADD(r0)
+             RADD_NEXTADD(8, r1)
+             RADD_NEXTADD(16, r2)
+             RADD_NEXTADD(24, r3)
+             RADD_NEXTADD(32, r4)
+             RADD_NEXTADD(40, r5)
+             RED_STORE(0, r0)
+             RED_STORE(8, r1)
+             RED_STORE(16, r2)
+             RED_STORE(24, r3)
+             RED_STORE(32, r4)
+             RED_STORE(40, r5)
+             RED_FIRSTSUB_2P(r0)
+             RED_NEXTSUB_2P(8, r1)
+             RED_NEXTSUB_2P(16, r2)
+             RED_NEXTSUB_2P(24, r3)
+             RED_NEXTSUB_2P(32, r4)
+             RED_NEXTSUB_2P(40, r5)
+             RED_CMOVC(0, r0)
+             RED_CMOVC(8, r1)
+             RED_CMOVC(16, r2)
+             RED_CMOVC(24, r3)
+             RED_CMOVC(32, r4)
+             RED_CMOVC(40, r5)
+             RED_STORE(0, r0)
+             RED_STORE(8, r1)
+             RED_STORE(16, r2)
+             RED_STORE(24, r3)
+             RED_STORE(32, r4)
+             RED_STORE(40, r5)
+             : [r0] "=&r" (r0), [r1] "=&r" (r1), [r2] "=&r" (r2), [r3] "=&r" (r3), [r4] "=&r" (r4), [r5] "=&r" (r5)
+             : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [D] "r" (double_modulus().data)
+             : "cc", "memory");
+    }
+    else
+#endif
+    {
+        add_portable(other, has_constexpr_params());
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp_model<n,modulus>::sub_redundant(const Fp_model<n,modulus>& other)
+{
+#if defined(__x86_64__) && defined(USE_ASM)
+    if (n == 4)
+    {
+        mp_limb_t r0, r1, r2, r3;
+        __asm__ volatile
+            (RSUB_FIRSTSUB(r0)
+             RSUB_NEXTSUB(8, r1)
+             RSUB_NEXTSUB(16, r2)
+             RSUB_NEXTSUB(24, r3)
+             "sbbq    %%rax, %%rax            \n\t"
+             RED_STORE(0, r0)
+             RED_STORE(8, r1)
+             RED_STORE(16, r2)
+             RED_STORE(24, r3)
+             RED_FIRSTADD_2P(r0)
+             RED_NEXTADD_2P(8, r1)
+             RED_NEXTADD_2P(16, r2)
+             RED_NEXTADD_2P(24, r3)
+             "testq   %%rax, %%rax            \n\t"
+             RED_CMOVZ(0, r0)
+             RED_CMOVZ(8, r1)
+             RED_CMOVZ(16, r2)
+             RED_CMOVZ(24, r3)
+             RED_STORE(0, r0)
+             RED_STORE(8, r1)
+             RED_STORE(16, r2)
+             RED_STORE(24, r3)
+             : [r0] "=&r" (r0), [r1] "=&r" (r1), [r2] "=&r" (r2), [r3] "=&r" (r3)
+             : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [D] "r" (double_modulus().data)
+             : "cc", "memory", "%rax");
+    }
+    else if (n == 6)
+    {
+        mp_limb_t r0, r1, r2, r3, r4, r5;
+        __asm__ volatile
+            (RSUB_FIRSTSUB(r0)
+             RSUB_NEXTSUB(8, r1)
+             RSUB_NEXTSUB(16, r2)
+             RSUB_NEXTSUB(24, r3)
+             RSUB_NEXTSUB(32, r4)
+             RSUB_NEXTSUB(40, r5)
+             "sbbq    %%rax, %%rax            \n\t"
+             RED_STORE(0, r0)
+             RED_STORE(8, r1)
+             RED_STORE(16, r2)
+             RED_STORE(24, r3)
+             RED_STORE(32, r4)
+             RED_STORE(40, r5)
+             RED_FIRSTADD_2P(r0)
+             RED_NEXTADD_2P(8, r1)
+             RED_NEXTADD_2P(16, r2)
+             RED_NEXTADD_2P(24, r3)
+             RED_NEXTADD_2P(32, r4)
+             RED_NEXTADD_2P(40, r5)
+             "testq   %%rax, %%rax            \n\t"
+             RED_CMOVZ(0, r0)
+             RED_CMOVZ(8, r1)
+             RED_CMOVZ(16, r2)
+             RED_CMOVZ(24, r3)
+             RED_CMOVZ(32, r4)
+             RED_CMOVZ(40, r5)
+             RED_STORE(0, r0)
+             RED_STORE(8, r1)
+             RED_STORE(16, r2)
+             RED_STORE(24, r3)
+             RED_STORE(32, r4)
+             RED_STORE(40, r5)
+             : [r0] "=&r" (r0), [r1] "=&r" (r1), [r2] "=&r" (r2), [r3] "=&r" (r3), [r4] "=&r" (r4), [r5] "=&r" (r5)
+             : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [D] "r" (double_modulus().data)
+             : "cc", "memory", "%rax");
+    }
+    else
+#endif
+    {
+        sub_portable(other, has_constexpr_params());
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n,modulus>& Fp_model<n,modulus>::operator*=(const Fp_model<n,modulus>& other)
+{
+#ifdef PROFILE_OP_COUNTS
+    this->mul_cnt++;
+#endif
+
+    mul_reduce(other.mont_repr);
+    return *this;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n,modulus>& Fp_model<n,modulus>::operator^=(const unsigned long pow)
+{
+    (*this) = power<Fp_model<n, modulus> >(*this, pow);
+    return (*this);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+template<mp_size_t m>
+Fp_model<n,modulus>& Fp_model<n,modulus>::operator^=(const bigint<m> &pow)
 {
     (*this) = power<Fp_model<n, modulus>, m>(*this, pow);
     return (*this);
@@ -600,14 +1332,21 @@ Fp_model<n,modulus> Fp_model<n,modulus>::operator-() const
     this->sub_cnt++;
 #endif
 
-    if (this->is_zero())
+    if (is_redundant || n <= 2)
+    {
+        /* 0 - x, wrapping around by the modulus (2p if is_redundant) unless x = 0 */
+        Fp_model<n, modulus> r = zero();
+        r.sub_portable(*this, has_constexpr_params());
+        return r;
+    }
+    else if (this->is_zero())
     {
         return (*this);
     }
     else
     {
         Fp_model<n, modulus> r;
-        mpn_sub_n(r.mont_repr.data, modulus.data, this->mont_repr.data, n);
+        limbs_sub<n>(r.mont_repr.data, modulus.data, this->mont_repr.data);
         return r;
     }
 }
@@ -617,7 +1356,6 @@ Fp_model<n,modulus> Fp_model<n,modulus>::squared() const
 {
 #ifdef PROFILE_OP_COUNTS
     this->sqr_cnt++;
-    this->mul_cnt--; // zero out the upcoming mul
 #endif
     /* stupid pre-processor tricks; beware */
 #if defined(__x86_64__) && defined(USE_ASM)
@@ -631,30 +1369,147 @@ Fp_model<n,modulus> Fp_model<n,modulus>::squared() const
         mp_limb_t tmp1, tmp2, tmp3;
         REDUCE_6_LIMB_PRODUCT(k, tmp1, tmp2, tmp3, inv, res, modulus.data);
 
-        /* subtract t > mod */
-        __asm__ volatile
-            ("/* check for overflow */        \n\t"
-             MONT_CMP(16)
-             MONT_CMP(8)
-             MONT_CMP(0)
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__ volatile
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
 
-             "/* subtract mod if overflow */  \n\t"
-             "subtract%=:                     \n\t"
-             MONT_FIRSTSUB
-             MONT_NEXTSUB(8)
-             MONT_NEXTSUB(16)
-             "done%=:                         \n\t"
-             :
-             : [tmp] "r" (res+n), [M] "r" (modulus.data)
-             : "cc", "memory", "%rax");
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (res+n), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
 
         Fp_model<n, modulus> r;
-        mpn_copyi(r.mont_repr.data, res+n, n);
+        limbs_copy<n>(r.mont_repr.data, res+n);
+        return r;
+    }
+    else if (n == 4 && !use_mulx_adx)
+    { // use asm-optimized Comba squaring, followed by a separate reduction
+        mp_limb_t res[2*n];
+        mp_limb_t c0, c1, c2;
+        COMBA_4_BY_4_SQR(c0, c1, c2, res, this->mont_repr.data);
+
+        mp_limb_t k, hi, cy;
+        REDUCE_8_LIMB_PRODUCT(k, hi, cy, inv, res, modulus.data);
+
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__ volatile
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(24)
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
+
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 MONT_NEXTSUB(24)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (res+n), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
+
+        Fp_model<n, modulus> r;
+        limbs_copy<n>(r.mont_repr.data, res+n);
+        return r;
+    }
+    else if (n == 5 && !use_mulx_adx)
+    { // use asm-optimized Comba squaring, followed by a separate reduction
+        mp_limb_t res[2*n];
+        mp_limb_t c0, c1, c2;
+        COMBA_5_BY_5_SQR(c0, c1, c2, res, this->mont_repr.data);
+
+        mp_limb_t k, hi, cy;
+        REDUCE_10_LIMB_PRODUCT(k, hi, cy, inv, res, modulus.data);
+
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__ volatile
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(32)
+                 MONT_CMP(24)
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
+
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 MONT_NEXTSUB(24)
+                 MONT_NEXTSUB(32)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (res+n), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
+
+        Fp_model<n, modulus> r;
+        limbs_copy<n>(r.mont_repr.data, res+n);
+        return r;
+    }
+    else if (n == 6 && !use_mulx_adx)
+    { // use asm-optimized Comba squaring, followed by a separate reduction
+        mp_limb_t res[2*n];
+        mp_limb_t c0, c1, c2;
+        COMBA_6_BY_6_SQR(c0, c1, c2, res, this->mont_repr.data);
+
+        mp_limb_t k, hi, cy;
+        REDUCE_12_LIMB_PRODUCT(k, hi, cy, inv, res, modulus.data);
+
+        /* subtract t > mod (not needed if is_redundant: t < 2p) */
+        if (!is_redundant)
+        {
+            __asm__ volatile
+                ("/* check for overflow */        \n\t"
+                 MONT_CMP(40)
+                 MONT_CMP(32)
+                 MONT_CMP(24)
+                 MONT_CMP(16)
+                 MONT_CMP(8)
+                 MONT_CMP(0)
+
+                 "/* subtract mod if overflow */  \n\t"
+                 "subtract%=:                     \n\t"
+                 MONT_FIRSTSUB
+                 MONT_NEXTSUB(8)
+                 MONT_NEXTSUB(16)
+                 MONT_NEXTSUB(24)
+                 MONT_NEXTSUB(32)
+                 MONT_NEXTSUB(40)
+                 "done%=:                         \n\t"
+                 :
+                 : [tmp] "r" (res+n), [M] "r" (modulus.data)
+                 : "cc", "memory", "%rax");
+        }
+
+        Fp_model<n, modulus> r;
+        limbs_copy<n>(r.mont_repr.data, res+n);
         return r;
     }
     else
 #endif
     {
+#ifdef PROFILE_OP_COUNTS
+        this->mul_cnt--; // zero out the upcoming mul
+#endif
         Fp_model<n, modulus> r(*this);
         return (r *= r);
     }
@@ -667,6 +1522,235 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::square()
     return (*this);
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_wide_model<n,modulus> Fp_model<n,modulus>::mul_unreduced(const Fp_model<n,modulus>& other) const
+{
+#ifdef PROFILE_OP_COUNTS
+    this->mul_cnt++;
+#endif
+    Fp_wide_model<n, modulus> r;
+    /* stupid pre-processor tricks; beware */
+#if defined(__x86_64__) && defined(USE_ASM)
+    mp_limb_t c0, c1, c2;
+    if (n == 4 && use_mulx_adx)
+    { // the rows of the mulx/adcx/adox-based mul_reduce, without the reduction rows
+        mp_limb_t t0, t1, t2, t3, t4, hi;
+        __asm__ (MULX_FIRSTROUND_BEGIN(t0, t1)
+                 MULX_FIRSTROUND_STEP(1, t1, t2)
+                 MULX_FIRSTROUND_STEP(2, t2, t3)
+                 MULX_FIRSTROUND_STEP(3, t3, t4)
+                 MULX_FIRSTROUND_END(t4)
+                 MULX_STORE(0, t0)
+                 MULX_ROUND_BEGIN(1)
+                 MULX_MUL_STEP(0, t1, t2)
+                 MULX_MUL_STEP(1, t2, t3)
+                 MULX_MUL_STEP(2, t3, t4)
+                 MULX_MUL_STEP(3, t4, t0)
+                 MULX_CARRY(t0)
+                 MULX_STORE(1, t1)
+                 MULX_ROUND_BEGIN(2)
+                 MULX_MUL_STEP(0, t2, t3)
+                 MULX_MUL_STEP(1, t3, t4)
+                 MULX_MUL_STEP(2, t4, t0)
+                 MULX_MUL_STEP(3, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_STORE(2, t2)
+                 MULX_ROUND_BEGIN(3)
+                 MULX_MUL_STEP(0, t3, t4)
+                 MULX_MUL_STEP(1, t4, t0)
+                 MULX_MUL_STEP(2, t0, t1)
+                 MULX_MUL_STEP(3, t1, t2)
+                 MULX_CARRY(t2)
+                 MULX_STORE(3, t3)
+                 : [t0] "=&r" (t0), [t1] "=&r" (t1), [t2] "=&r" (t2), [t3] "=&r" (t3), [t4] "=&r" (t4),
+                   [hi] "=&r" (hi)
+                 : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [R] "r" (r.repr.data)
+                 : "cc", "memory", "%rax", "%rdx"
+        );
+        r.repr.data[4] = t4;
+        r.repr.data[5] = t0;
+        r.repr.data[6] = t1;
+        r.repr.data[7] = t2;
+    }
+    else if (n == 5 && use_mulx_adx)
+    { // as above
+        mp_limb_t t0, t1, t2, t3, t4, t5, hi;
+        __asm__ (MULX_FIRSTROUND_BEGIN(t0, t1)
+                 MULX_FIRSTROUND_STEP(1, t1, t2)
+                 MULX_FIRSTROUND_STEP(2, t2, t3)
+                 MULX_FIRSTROUND_STEP(3, t3, t4)
+                 MULX_FIRSTROUND_STEP(4, t4, t5)
+                 MULX_FIRSTROUND_END(t5)
+                 MULX_STORE(0, t0)
+                 MULX_ROUND_BEGIN(1)
+                 MULX_MUL_STEP(0, t1, t2)
+                 MULX_MUL_STEP(1, t2, t3)
+                 MULX_MUL_STEP(2, t3, t4)
+                 MULX_MUL_STEP(3, t4, t5)
+                 MULX_MUL_STEP(4, t5, t0)
+                 MULX_CARRY(t0)
+                 MULX_STORE(1, t1)
+                 MULX_ROUND_BEGIN(2)
+                 MULX_MUL_STEP(0, t2, t3)
+                 MULX_MUL_STEP(1, t3, t4)
+                 MULX_MUL_STEP(2, t4, t5)
+                 MULX_MUL_STEP(3, t5, t0)
+                 MULX_MUL_STEP(4, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_STORE(2, t2)
+                 MULX_ROUND_BEGIN(3)
+                 MULX_MUL_STEP(0, t3, t4)
+                 MULX_MUL_STEP(1, t4, t5)
+                 MULX_MUL_STEP(2, t5, t0)
+                 MULX_MUL_STEP(3, t0, t1)
+                 MULX_MUL_STEP(4, t1, t2)
+                 MULX_CARRY(t2)
+                 MULX_STORE(3, t3)
+                 MULX_ROUND_BEGIN(4)
+                 MULX_MUL_STEP(0, t4, t5)
+                 MULX_MUL_STEP(1, t5, t0)
+                 MULX_MUL_STEP(2, t0, t1)
+                 MULX_MUL_STEP(3, t1, t2)
+                 MULX_MUL_STEP(4, t2, t3)
+                 MULX_CARRY(t3)
+                 MULX_STORE(4, t4)
+                 : [t0] "=&r" (t0), [t1] "=&r" (t1), [t2] "=&r" (t2), [t3] "=&r" (t3), [t4] "=&r" (t4), [t5] "=&r" (t5),
+                   [hi] "=&r" (hi)
+                 : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [R] "r" (r.repr.data)
+                 : "cc", "memory", "%rax", "%rdx"
+        );
+        r.repr.data[5] = t5;
+        r.repr.data[6] = t0;
+        r.repr.data[7] = t1;
+        r.repr.data[8] = t2;
+        r.repr.data[9] = t3;
+    }
+    else if (n == 6 && use_mulx_adx)
+    { // as above
+        mp_limb_t t0, t1, t2, t3, t4, t5, t6, hi;
+        __asm__ (MULX_FIRSTROUND_BEGIN(t0, t1)
+                 MULX_FIRSTROUND_STEP(1, t1, t2)
+                 MULX_FIRSTROUND_STEP(2, t2, t3)
+                 MULX_FIRSTROUND_STEP(3, t3, t4)
+                 MULX_FIRSTROUND_STEP(4, t4, t5)
+                 MULX_FIRSTROUND_STEP(5, t5, t6)
+                 MULX_FIRSTROUND_END(t6)
+                 MULX_STORE(0, t0)
+                 MULX_ROUND_BEGIN(1)
+                 MULX_MUL_STEP(0, t1, t2)
+                 MULX_MUL_STEP(1, t2, t3)
+                 MULX_MUL_STEP(2, t3, t4)
+                 MULX_MUL_STEP(3, t4, t5)
+                 MULX_MUL_STEP(4, t5, t6)
+                 MULX_MUL_STEP(5, t6, t0)
+                 MULX_CARRY(t0)
+                 MULX_STORE(1, t1)
+                 MULX_ROUND_BEGIN(2)
+                 MULX_MUL_STEP(0, t2, t3)
+                 MULX_MUL_STEP(1, t3, t4)
+                 MULX_MUL_STEP(2, t4, t5)
+                 MULX_MUL_STEP(3, t5, t6)
+                 MULX_MUL_STEP(4, t6, t0)
+                 MULX_MUL_STEP(5, t0, t1)
+                 MULX_CARRY(t1)
+                 MULX_STORE(2, t2)
+                 MULX_ROUND_BEGIN(3)
+                 MULX_MUL_STEP(0, t3, t4)
+                 MULX_MUL_STEP(1, t4, t5)
+                 MULX_MUL_STEP(2, t5, t6)
+                 MULX_MUL_STEP(3, t6, t0)
+                 MULX_MUL_STEP(4, t0, t1)
+                 MULX_MUL_STEP(5, t1, t2)
+                 MULX_CARRY(t2)
+                 MULX_STORE(3, t3)
+                 MULX_ROUND_BEGIN(4)
+                 MULX_MUL_STEP(0, t4, t5)
+                 MULX_MUL_STEP(1, t5, t6)
+                 MULX_MUL_STEP(2, t6, t0)
+                 MULX_MUL_STEP(3, t0, t1)
+                 MULX_MUL_STEP(4, t1, t2)
+                 MULX_MUL_STEP(5, t2, t3)
+                 MULX_CARRY(t3)
+                 MULX_STORE(4, t4)
+                 MULX_ROUND_BEGIN(5)
+                 MULX_MUL_STEP(0, t5, t6)
+                 MULX_MUL_STEP(1, t6, t0)
+                 MULX_MUL_STEP(2, t0, t1)
+                 MULX_MUL_STEP(3, t1, t2)
+                 MULX_MUL_STEP(4, t2, t3)
+                 MULX_MUL_STEP(5, t3, t4)
+                 MULX_CARRY(t4)
+                 MULX_STORE(5, t5)
+                 : [t0] "=&r" (t0), [t1] "=&r" (t1), [t2] "=&r" (t2), [t3] "=&r" (t3), [t4] "=&r" (t4), [t5] "=&r" (t5), [t6] "=&r" (t6),
+                   [hi] "=&r" (hi)
+                 : [A] "r" (this->mont_repr.data), [B] "r" (other.mont_repr.data), [R] "r" (r.repr.data)
+                 : "cc", "memory", "%rax", "%rdx"
+        );
+        r.repr.data[6] = t6;
+        r.repr.data[7] = t0;
+        r.repr.data[8] = t1;
+        r.repr.data[9] = t2;
+        r.repr.data[10] = t3;
+        r.repr.data[11] = t4;
+    }
+    else if (n == 3)
+    {
+        COMBA_3_BY_3_MUL(c0, c1, c2, r.repr.data, this->mont_repr.data, other.mont_repr.data);
+    }
+    else if (n == 4)
+    {
+        COMBA_4_BY_4_MUL(c0, c1, c2, r.repr.data, this->mont_repr.data, other.mont_repr.data);
+    }
+    else if (n == 5)
+    {
+        COMBA_5_BY_5_MUL(c0, c1, c2, r.repr.data, this->mont_repr.data, other.mont_repr.data);
+    }
+    else if (n == 6)
+    {
+        COMBA_6_BY_6_MUL(c0, c1, c2, r.repr.data, this->mont_repr.data, other.mont_repr.data);
+    }
+    else
+#endif
+    {
+        limbs_mul<n>(r.repr.data, this->mont_repr.data, other.mont_repr.data);
+    }
+    return r;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_wide_model<n,modulus> Fp_model<n,modulus>::squared_unreduced() const
+{
+#ifdef PROFILE_OP_COUNTS
+    this->sqr_cnt++;
+#endif
+    Fp_wide_model<n, modulus> r;
+    /* stupid pre-processor tricks; beware */
+#if defined(__x86_64__) && defined(USE_ASM)
+    mp_limb_t c0, c1, c2;
+    if (n == 3)
+    {
+        COMBA_3_BY_3_SQR(c0, c1, c2, r.repr.data, this->mont_repr.data);
+    }
+    else if (n == 4)
+    {
+        COMBA_4_BY_4_SQR(c0, c1, c2, r.repr.data, this->mont_repr.data);
+    }
+    else if (n == 5)
+    {
+        COMBA_5_BY_5_SQR(c0, c1, c2, r.repr.data, this->mont_repr.data);
+    }
+    else if (n == 6)
+    {
+        COMBA_6_BY_6_SQR(c0, c1, c2, r.repr.data, this->mont_repr.data);
+    }
+    else
+#endif
+    {
+        limbs_sqr<n>(r.repr.data, this->mont_repr.data);
+    }
+    return r;
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 Fp_model<n,modulus>& Fp_model<n,modulus>::invert()
 {
@@ -681,10 +1765,11 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::invert()
     mp_limb_t s[n+1]; /* sp should have room for vn+1 limbs */
     mp_size_t sn;
 
-    bigint<n> v = modulus; // both source operands are destroyed by mpn_gcdext
+    bigint<n> u = this->canonical_mont_repr(); // both source operands are destroyed by mpn_gcdext
+    bigint<n> v = modulus;
 
     /* computes gcd(u, v) = g = u*s + v*t, so s*u will be 1 (mod v) */
-    const mp_size_t gn = mpn_gcdext(g.data, s, &sn, this->mont_repr.data, n, v.data, n);
+    const mp_size_t gn = mpn_gcdext(g.data, s, &sn, u.data, n, v.data, n);
 #ifndef NDEBUG
     assert(gn == 1 && g.data[0] == 1); /* inverse exists */
 #else
@@ -717,6 +1802,23 @@ Fp_model<n,modulus>& Fp_model<n,modulus>::invert()
 #endif
     }
 
+    /* (xR)^(-1) * R^3 / R = x^(-1) R */
+    mul_reduce(Rcubed);
+    return *this;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n,modulus>& Fp_model<n,modulus>::invert_constant_time()
+{
+#ifdef PROFILE_OP_COUNTS
+    this->inv_cnt++;
+#endif
+
+    assert(!this->is_zero());
+
+    /* (xR)^(-1) * R^3 / R = x^(-1) R */
+    this->mont_repr = safegcd_inverse(this->canonical_mont_repr(), modulus, modulus.num_bits());
+
     mul_reduce(Rcubed);
     return *this;
 }
@@ -728,6 +1830,13 @@ Fp_model<n,modulus> Fp_model<n,modulus>::inverse() const
     return (r.invert());
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n,modulus> Fp_model<n,modulus>::inverse_constant_time() const
+{
+    Fp_model<n, modulus> r(*this);
+    return (r.invert_constant_time());
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 Fp_model<n,modulus> Fp_model<n,modulus>::Frobenius_map(unsigned long power) const
 {
@@ -761,7 +1870,7 @@ Fp_model<n,modulus> Fp_model<n,modulus>::random_element() /// returns random ele
         }
     }
    /* if r.data is still >= modulus -- repeat (rejection sampling) */
-    while (mpn_cmp(r.mont_repr.data, modulus.data, n) >= 0);
+    while (limbs_cmp<n>(r.mont_repr.data, modulus.data) >= 0);
 
     return r;
 }
@@ -769,9 +1878,41 @@ Fp_model<n,modulus> Fp_model<n,modulus>::random_element() /// returns random ele
 template<mp_size_t n, const bigint<n>& modulus>
 Fp_model<n,modulus> Fp_model<n,modulus>::sqrt() const
 {
+    if (s == 1)
+    {
+        /* p = 3 (mod 4), so for a square x, x^((p+1)/4) is a square root */
+        static const addition_chain p_plus_1_over_4_chain([]() {
+            bigint<n> e = modulus;
+            limbs_add_1<n>(e.data, e.data, 1);
+            limbs_rshift<n>(e.data, e.data, 2);
+            return e;
+        }());
+        return p_plus_1_over_4_chain.evaluate(*this);
+    }
+
+    if (s >= sqrt_table_min_s)
+    {
+        /* Tonelli-Shanks takes O(s^2) squarings, so look the root up instead */
+        static const sqrt_table<Fp_model<n, modulus> > table;
+        return table.sqrt(*this);
+    }
+
     return tonelli_shanks_sqrt(*this);
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+int Fp_model<n,modulus>::legendre() const
+{
+    /* R = 2^(64n) is a square, so the Montgomery form has the same symbol */
+    return jacobi_symbol(this->canonical_mont_repr(), modulus);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+bool Fp_model<n,modulus>::is_square() const
+{
+    return (this->legendre() != -1);
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 std::vector<uint64_t> Fp_model<n,modulus>::to_words() const
 {
@@ -828,11 +1969,261 @@ bigint<n> Fp_model<n,modulus>::bigint_repr() const
     // If the flag is defined, serialization and words output use the montgomery representation
     // instead of the human-readable value.
 if (montgomery_output) {
-    return this->mont_repr;
+    return this->canonical_mont_repr();
 } else {
     return this->as_bigint();
 }
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_wide_model<n,modulus>& Fp_wide_model<n,modulus>::operator+=(const Fp_wide_model<n,modulus>& other)
+{
+#ifdef PROFILE_OP_COUNTS
+    Fp_model<n, modulus>::add_cnt++;
+#endif
+    const mp_limb_t carry = limbs_add<2*n>(this->repr.data, this->repr.data, other.repr.data);
+    /* keep the upper half below the modulus, i.e. subtract p*R if needed */
+    if (carry || limbs_cmp<n>(this->repr.data + n, modulus.data) >= 0)
+    {
+        limbs_sub<n>(this->repr.data + n, this->repr.data + n, modulus.data);
+    }
+    return *this;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_wide_model<n,modulus>& Fp_wide_model<n,modulus>::operator-=(const Fp_wide_model<n,modulus>& other)
+{
+#ifdef PROFILE_OP_COUNTS
+    Fp_model<n, modulus>::sub_cnt++;
+#endif
+    const mp_limb_t borrow = limbs_sub<2*n>(this->repr.data, this->repr.data, other.repr.data);
+    /* wrap around by adding p*R; the carry out cancels the borrow */
+    if (borrow)
+    {
+        limbs_add<n>(this->repr.data + n, this->repr.data + n, modulus.data);
+    }
+    return *this;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_wide_model<n,modulus> Fp_wide_model<n,modulus>::operator+(const Fp_wide_model<n,modulus>& other) const
+{
+    Fp_wide_model<n, modulus> r(*this);
+    return (r += other);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_wide_model<n,modulus> Fp_wide_model<n,modulus>::operator-(const Fp_wide_model<n,modulus>& other) const
+{
+    Fp_wide_model<n, modulus> r(*this);
+    return (r -= other);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_model<n,modulus> Fp_wide_model<n,modulus>::reduce() const
+{
+    const mp_limb_t inv = Fp_model<n, modulus>::inv;
+    mp_limb_t res[2*n];
+    limbs_copy<2*n>(res, this->repr.data);
+    /* the carry out of the top limb, which is always 0 if the modulus has a spare top bit */
+    mp_limb_t carry = 0;
+
+    /* stupid pre-processor tricks; beware */
+#if defined(__x86_64__) && defined(USE_ASM)
+    /* the assembly reductions drop the final carry, so need the spare bit */
+    const bool spare_bit = (modulus.data[n-1] >> (GMP_NUMB_BITS - 1)) == 0;
+    if (n == 3 && spare_bit)
+    {
+        mp_limb_t k;
+        mp_limb_t tmp1, tmp2, tmp3;
+        REDUCE_6_LIMB_PRODUCT(k, tmp1, tmp2, tmp3, inv, res, modulus.data);
+    }
+    else if (n == 4 && spare_bit)
+    {
+        mp_limb_t k, hi, cy;
+        REDUCE_8_LIMB_PRODUCT(k, hi, cy, inv, res, modulus.data);
+    }
+    else if (n == 5 && spare_bit)
+    {
+        mp_limb_t k, hi, cy;
+        REDUCE_10_LIMB_PRODUCT(k, hi, cy, inv, res, modulus.data);
+    }
+    else if (n == 6 && spare_bit)
+    {
+        mp_limb_t k, hi, cy;
+        REDUCE_12_LIMB_PRODUCT(k, hi, cy, inv, res, modulus.data);
+    }
+    else
+#endif
+    {
+        /*
+          Algorithm 14.32 in Handbook of Applied Cryptography, keeping the
+          carry out of res[n+i] for the next row instead of propagating it
+        */
+        for (size_t i = 0; i < n; ++i)
+        {
+            const mp_limb_t k = inv * res[i];
+            /* calculate res = res + k * mod * b^i */
+            const dlimb_t c = (dlimb_t)res[n+i] + limbs_addmul_1<n>(res+i, modulus.data, k) + carry;
+            res[n+i] = (mp_limb_t)c;
+            carry = (mp_limb_t)(c >> GMP_NUMB_BITS);
+        }
+    }
+
+    /*
+      The input is below p*R, so the reduced value carry * R + res[n..2n-1]
+      is below 2p; without a spare bit it can exceed R, and subtracting p
+      then borrows exactly the carry.
+    */
+    if (!Fp_model<n, modulus>::is_redundant && (carry || limbs_cmp<n>(res+n, modulus.data) >= 0))
+    {
+        limbs_sub<n>(res+n, res+n, modulus.data);
+    }
+
+    Fp_model<n, modulus> r;
+    limbs_copy<n>(r.mont_repr.data, res+n);
+    return r;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp_wide_model<n,modulus> Fp_wide_model<n,modulus>::zero()
+{
+    Fp_wide_model<n, modulus> r;
+    r.repr.clear();
+    return r;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_mul(std::vector<Fp_model<n, modulus> > &vec, const std::vector<Fp_model<n, modulus> > &other)
+{
+    assert(vec.size() == other.size());
+#if defined(__x86_64__) && defined(USE_ASM)
+    static_assert(sizeof(Fp_model<n, modulus>) == n * sizeof(mp_limb_t), "Fp_model must be a plain array of limbs");
+    if (n == 4 && use_avx512_ifma && (modulus.data[n-1] >> (GMP_NUMB_BITS - 1)) == 0)
+    {
+#ifdef PROFILE_OP_COUNTS
+        Fp_model<n, modulus>::mul_cnt += vec.size();
+#endif
+        mp_limb_t *res = reinterpret_cast<mp_limb_t*>(vec.data());
+        const mp_limb_t *b = reinterpret_cast<const mp_limb_t*>(other.data());
+        mul_4_limb_ifma(res, res, b, false, vec.size(), modulus.data, Fp_model<n, modulus>::inv);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        vec[i] *= other[i];
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_square(std::vector<Fp_model<n, modulus> > &vec)
+{
+#if defined(__x86_64__) && defined(USE_ASM)
+    if (n == 4 && use_avx512_ifma && (modulus.data[n-1] >> (GMP_NUMB_BITS - 1)) == 0)
+    {
+#ifdef PROFILE_OP_COUNTS
+        Fp_model<n, modulus>::sqr_cnt += vec.size();
+#endif
+        mp_limb_t *res = reinterpret_cast<mp_limb_t*>(vec.data());
+        mul_4_limb_ifma(res, res, res, false, vec.size(), modulus.data, Fp_model<n, modulus>::inv);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        vec[i].square();
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void batch_mul_scalar(std::vector<Fp_model<n, modulus> > &vec, const Fp_model<n, modulus> &c)
+{
+#if defined(__x86_64__) && defined(USE_ASM)
+    if (n == 4 && use_avx512_ifma && (modulus.data[n-1] >> (GMP_NUMB_BITS - 1)) == 0)
+    {
+#ifdef PROFILE_OP_COUNTS
+        Fp_model<n, modulus>::mul_cnt += vec.size();
+#endif
+        mp_limb_t *res = reinterpret_cast<mp_limb_t*>(vec.data());
+        mul_4_limb_ifma(res, res, c.mont_repr.data, true, vec.size(), modulus.data, Fp_model<n, modulus>::inv);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        vec[i] *= c;
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+std::vector<int> batch_legendre(const std::vector<Fp_model<n, modulus> > &vec)
+{
+    std::vector<int> result(vec.size());
+    for (size_t i = 0; i < vec.size(); ++i)
+    {
+        result[i] = vec[i].legendre();
+    }
+    return result;
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void to_bigints(const Fp_model<n, modulus> *elements, const size_t count, bigint<n> *result)
+{
+    const size_t chunk_size = 4096;
+    const size_t num_chunks = (count + chunk_size - 1) / chunk_size;
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t c = 0; c < num_chunks; ++c)
+    {
+        const size_t start = c * chunk_size;
+        const size_t end = std::min(count, start + chunk_size);
+#if defined(__x86_64__) && defined(USE_ASM)
+        static_assert(sizeof(bigint<n>) == n * sizeof(mp_limb_t), "bigint must be a plain array of limbs");
+        if (n == 4 && use_avx512_ifma && (modulus.data[n-1] >> (GMP_NUMB_BITS - 1)) == 0)
+        {
+            /* montgomery_reduce(x * 1) is below p even for redundant x < 2p */
+            const bigint<n> one = bigint<n>::one();
+            mul_4_limb_ifma(result[start].data, elements[start].mont_repr.data, one.data, true,
+                            end - start, modulus.data, Fp_model<n, modulus>::inv);
+            continue;
+        }
+#endif
+        for (size_t i = start; i < end; ++i)
+        {
+            result[i] = elements[i].as_bigint();
+        }
+    }
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void from_bigints(const bigint<n> *values, const size_t count, Fp_model<n, modulus> *result)
+{
+    const size_t chunk_size = 4096;
+    const size_t num_chunks = (count + chunk_size - 1) / chunk_size;
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t c = 0; c < num_chunks; ++c)
+    {
+        const size_t start = c * chunk_size;
+        const size_t end = std::min(count, start + chunk_size);
+#if defined(__x86_64__) && defined(USE_ASM)
+        if (n == 4 && use_avx512_ifma && (modulus.data[n-1] >> (GMP_NUMB_BITS - 1)) == 0)
+        {
+            mul_4_limb_ifma(result[start].mont_repr.data, values[start].data, Fp_model<n, modulus>::Rsquared.data, true,
+                            end - start, modulus.data, Fp_model<n, modulus>::inv);
+            continue;
+        }
+#endif
+        for (size_t i = start; i < end; ++i)
+        {
+            result[i].mont_repr = Fp_model<n, modulus>::Rsquared;
+            result[i].mul_reduce(values[i]);
+        }
+    }
+}
+
 } // namespace libff
 #endif // FP_TCC_
@@ -0,0 +1,252 @@
+/** @file
+ *****************************************************************************
+ AVX-512 IFMA kernels for elementwise arithmetic on arrays of 4-limb F[p]
+ elements. See fp_ifma.hpp .
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cassert>
+
+#include <libff/algebra/fields/prime_base/fp_ifma.hpp>
+#include <libff/common/utils.hpp>
+
+#if defined(__x86_64__) && defined(USE_ASM)
+#include <immintrin.h>
+
+/* the library is not built with -mavx512*, so enable the extensions per function */
+#define IFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+
+#if defined(__GNUC__) && !defined(__clang__)
+/* GCC's own shift intrinsics use _mm512_undefined_epi32(), which trips these warnings */
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace libff {
+
+namespace {
+
+const unsigned long long radix52_mask = (1ull << 52) - 1;
+const unsigned long long radix48_mask = (1ull << 48) - 1;
+
+/*
+  Structure-of-arrays form of eight field elements: limb[j] holds bits
+  52*j .. 52*j+51 of each of the eight lanes.
+ */
+struct radix52_vec {
+    __m512i limb[5];
+};
+
+/*
+  Loads eight consecutive 4-limb elements and re-slices them into 52-bit
+  limbs. The 8x4 transpose takes two rounds of two-source permutes.
+ */
+IFMA_TARGET inline radix52_vec load_radix52(const mp_limb_t *src)
+{
+    const __m512i m52 = _mm512_set1_epi64(radix52_mask);
+    const __m512i lo_words = _mm512_set_epi64(13, 9, 5, 1, 12, 8, 4, 0);
+    const __m512i hi_words = _mm512_set_epi64(15, 11, 7, 3, 14, 10, 6, 2);
+    const __m512i lo_halves = _mm512_set_epi64(11, 10, 9, 8, 3, 2, 1, 0);
+    const __m512i hi_halves = _mm512_set_epi64(15, 14, 13, 12, 7, 6, 5, 4);
+
+    const __m512i e01 = _mm512_loadu_si512(src);
+    const __m512i e23 = _mm512_loadu_si512(src + 8);
+    const __m512i e45 = _mm512_loadu_si512(src + 16);
+    const __m512i e67 = _mm512_loadu_si512(src + 24);
+
+    /* words 0 and 1 (resp. 2 and 3) of elements 0..3 and 4..7 */
+    const __m512i w01_0123 = _mm512_permutex2var_epi64(e01, lo_words, e23);
+    const __m512i w23_0123 = _mm512_permutex2var_epi64(e01, hi_words, e23);
+    const __m512i w01_4567 = _mm512_permutex2var_epi64(e45, lo_words, e67);
+    const __m512i w23_4567 = _mm512_permutex2var_epi64(e45, hi_words, e67);
+
+    const __m512i w0 = _mm512_permutex2var_epi64(w01_0123, lo_halves, w01_4567);
+    const __m512i w1 = _mm512_permutex2var_epi64(w01_0123, hi_halves, w01_4567);
+    const __m512i w2 = _mm512_permutex2var_epi64(w23_0123, lo_halves, w23_4567);
+    const __m512i w3 = _mm512_permutex2var_epi64(w23_0123, hi_halves, w23_4567);
+
+    radix52_vec r;
+    r.limb[0] = _mm512_and_si512(w0, m52);
+    r.limb[1] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(w0, 52), _mm512_slli_epi64(w1, 12)), m52);
+    r.limb[2] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(w1, 40), _mm512_slli_epi64(w2, 24)), m52);
+    r.limb[3] = _mm512_and_si512(_mm512_or_si512(_mm512_srli_epi64(w2, 28), _mm512_slli_epi64(w3, 36)), m52);
+    r.limb[4] = _mm512_srli_epi64(w3, 16);
+    return r;
+}
+
+/* Broadcasts a single 4-limb value to all eight lanes. */
+IFMA_TARGET inline radix52_vec broadcast_radix52(const mp_limb_t *src)
+{
+    radix52_vec r;
+    r.limb[0] = _mm512_set1_epi64(src[0] & radix52_mask);
+    r.limb[1] = _mm512_set1_epi64(((src[0] >> 52) | (src[1] << 12)) & radix52_mask);
+    r.limb[2] = _mm512_set1_epi64(((src[1] >> 40) | (src[2] << 24)) & radix52_mask);
+    r.limb[3] = _mm512_set1_epi64(((src[2] >> 28) | (src[3] << 36)) & radix52_mask);
+    r.limb[4] = _mm512_set1_epi64(src[3] >> 16);
+    return r;
+}
+
+/* Inverse of load_radix52. */
+IFMA_TARGET inline void store_radix52(mp_limb_t *dst, const radix52_vec &v)
+{
+    const __m512i lo_words = _mm512_set_epi64(13, 5, 12, 4, 9, 1, 8, 0);
+    const __m512i hi_words = _mm512_set_epi64(15, 7, 14, 6, 11, 3, 10, 2);
+    const __m512i lo_halves = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+    const __m512i hi_halves = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+
+    const __m512i w0 = _mm512_or_si512(v.limb[0], _mm512_slli_epi64(v.limb[1], 52));
+    const __m512i w1 = _mm512_or_si512(_mm512_srli_epi64(v.limb[1], 12), _mm512_slli_epi64(v.limb[2], 40));
+    const __m512i w2 = _mm512_or_si512(_mm512_srli_epi64(v.limb[2], 24), _mm512_slli_epi64(v.limb[3], 28));
+    const __m512i w3 = _mm512_or_si512(_mm512_srli_epi64(v.limb[3], 36), _mm512_slli_epi64(v.limb[4], 16));
+
+    /* w01_lo holds words 0 and 1 of elements 0, 1, 4, 5 and w01_hi those of 2, 3, 6, 7 */
+    const __m512i w01_lo = _mm512_permutex2var_epi64(w0, lo_words, w1);
+    const __m512i w01_hi = _mm512_permutex2var_epi64(w0, hi_words, w1);
+    const __m512i w23_lo = _mm512_permutex2var_epi64(w2, lo_words, w3);
+    const __m512i w23_hi = _mm512_permutex2var_epi64(w2, hi_words, w3);
+
+    _mm512_storeu_si512(dst, _mm512_permutex2var_epi64(w01_lo, lo_halves, w23_lo));
+    _mm512_storeu_si512(dst + 8, _mm512_permutex2var_epi64(w01_hi, lo_halves, w23_hi));
+    _mm512_storeu_si512(dst + 16, _mm512_permutex2var_epi64(w01_lo, hi_halves, w23_lo));
+    _mm512_storeu_si512(dst + 24, _mm512_permutex2var_epi64(w01_hi, hi_halves, w23_hi));
+}
+
+/*
+  Montgomery multiplication with R = 2^256 on eight lanes at once.
+
+  The product is accumulated in ten 64-bit columns (the 52-bit partial
+  products leave 12 bits of headroom, enough for the 20 terms per column).
+  Four reduction rounds divide by 2^52 each and a final one by 2^48, so the
+  result matches Fp_model's radix-2^64 Montgomery form without any
+  conversion factor. The result is below 2p and is then conditionally
+  reduced by p.
+ */
+IFMA_TARGET inline radix52_vec mont_mul_radix52(const radix52_vec &a, const radix52_vec &b,
+                                                const radix52_vec &p, const __m512i pinv)
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i m52 = _mm512_set1_epi64(radix52_mask);
+    const __m512i m48 = _mm512_set1_epi64(radix48_mask);
+
+    __m512i t[10];
+    for (size_t i = 0; i < 10; ++i)
+    {
+        t[i] = zero;
+    }
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        for (size_t j = 0; j < 5; ++j)
+        {
+            t[i+j] = _mm512_madd52lo_epu64(t[i+j], a.limb[i], b.limb[j]);
+            t[i+j+1] = _mm512_madd52hi_epu64(t[i+j+1], a.limb[i], b.limb[j]);
+        }
+    }
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        /* madd52lo only looks at the low 52 bits of t[i], which is all that matters mod 2^52 */
+        __m512i m = _mm512_madd52lo_epu64(zero, t[i], pinv);
+        if (i == 4)
+        {
+            m = _mm512_and_si512(m, m48);
+        }
+        for (size_t j = 0; j < 5; ++j)
+        {
+            t[i+j] = _mm512_madd52lo_epu64(t[i+j], m, p.limb[j]);
+            t[i+j+1] = _mm512_madd52hi_epu64(t[i+j+1], m, p.limb[j]);
+        }
+        if (i < 4)
+        {
+            t[i+1] = _mm512_add_epi64(t[i+1], _mm512_srli_epi64(t[i], 52));
+        }
+    }
+
+    /* normalize the upper columns; the low 48 bits of t[4] are now zero */
+    for (size_t i = 4; i < 9; ++i)
+    {
+        t[i+1] = _mm512_add_epi64(t[i+1], _mm512_srli_epi64(t[i], 52));
+        t[i] = _mm512_and_si512(t[i], m52);
+    }
+
+    /* shift right by 256 = 4*52 + 48 bits */
+    radix52_vec r;
+    for (size_t j = 0; j < 5; ++j)
+    {
+        r.limb[j] = _mm512_or_si512(_mm512_srli_epi64(t[4+j], 48),
+                                    _mm512_and_si512(_mm512_slli_epi64(t[5+j], 4), m52));
+    }
+
+    /* subtract p where r >= p */
+    radix52_vec d;
+    __m512i borrow = zero;
+    for (size_t j = 0; j < 5; ++j)
+    {
+        const __m512i diff = _mm512_sub_epi64(_mm512_sub_epi64(r.limb[j], p.limb[j]), borrow);
+        borrow = _mm512_srli_epi64(diff, 63);
+        d.limb[j] = _mm512_and_si512(diff, m52);
+    }
+    const __mmask8 no_borrow = _mm512_cmpeq_epi64_mask(borrow, zero);
+    for (size_t j = 0; j < 5; ++j)
+    {
+        r.limb[j] = _mm512_mask_blend_epi64(no_borrow, r.limb[j], d.limb[j]);
+    }
+
+    return r;
+}
+
+} // namespace
+
+IFMA_TARGET void mul_4_limb_ifma(mp_limb_t *res, const mp_limb_t *a, const mp_limb_t *b, const bool b_is_scalar,
+                                 const std::size_t count, const mp_limb_t *mod, const mp_limb_t inv)
+{
+    assert((mod[3] >> 63) == 0);
+
+    const radix52_vec p = broadcast_radix52(mod);
+    const __m512i pinv = _mm512_set1_epi64(inv & radix52_mask);
+    const radix52_vec b_scalar = (b_is_scalar ? broadcast_radix52(b) : p);
+
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const radix52_vec x = load_radix52(a + 4*i);
+        const radix52_vec y = (b_is_scalar ? b_scalar : load_radix52(b + 4*i));
+        store_radix52(res + 4*i, mont_mul_radix52(x, y, p, pinv));
+    }
+
+    /* pad the last partial block with zeros */
+    if (i < count)
+    {
+        const std::size_t rest = 4 * (count - i);
+        mp_limb_t x_buf[32] = {0}, y_buf[32] = {0}, res_buf[32];
+        std::copy(a + 4*i, a + 4*i + rest, x_buf);
+        if (!b_is_scalar)
+        {
+            std::copy(b + 4*i, b + 4*i + rest, y_buf);
+        }
+        const radix52_vec y = (b_is_scalar ? b_scalar : load_radix52(y_buf));
+        store_radix52(res_buf, mont_mul_radix52(load_radix52(x_buf), y, p, pinv));
+        std::copy(res_buf, res_buf + rest, res + 4*i);
+    }
+}
+
+} // namespace libff
+
+#else
+
+namespace libff {
+
+void mul_4_limb_ifma(mp_limb_t *res, const mp_limb_t *a, const mp_limb_t *b, const bool b_is_scalar,
+                     const std::size_t count, const mp_limb_t *mod, const mp_limb_t inv)
+{
+    UNUSED(res, a, b, b_is_scalar, count, mod, inv);
+    assert(0 && "mul_4_limb_ifma requires USE_ASM on x86-64");
+}
+
+} // namespace libff
+
+#endif
@@ -0,0 +1,37 @@
+/** @file
+ *****************************************************************************
+ Declaration of AVX-512 IFMA kernels for elementwise arithmetic on arrays of
+ 4-limb F[p] elements, used by the Fp_model vector functions in fp.tcc .
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+
+#ifndef FP_IFMA_HPP_
+#define FP_IFMA_HPP_
+
+#include <cstddef>
+
+#include <gmp.h>
+
+namespace libff {
+
+/**
+ * Computes res[i] = montgomery_reduce(a[i] * b[i]) for count consecutive
+ * 4-limb Montgomery representatives, eight at a time. If b_is_scalar is set,
+ * b points to a single element that multiplies every a[i]. res may alias a
+ * or b.
+ *
+ * The elements are sliced into five 52-bit limbs, so the modulus must be
+ * below 2^255; inv is -modulus^(-1) mod 2^64, as in Fp_model.
+ *
+ * Only available when compiled with USE_ASM on x86-64, and only to be called
+ * when cpu_supports_avx512_ifma() is true.
+ */
+void mul_4_limb_ifma(mp_limb_t *res, const mp_limb_t *a, const mp_limb_t *b, const bool b_is_scalar,
+                     const std::size_t count, const mp_limb_t *mod, const mp_limb_t inv);
+
+} // namespace libff
+
+#endif // FP_IFMA_HPP_
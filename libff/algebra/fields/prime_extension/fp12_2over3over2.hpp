@@ -99,7 +99,7 @@ public:
     Fp12_2over3over2_model operator-() const;
 
     Fp12_2over3over2_model& square();
-    Fp12_2over3over2_model squared() const; // default is squared_complex
+    Fp12_2over3over2_model squared() const; // default is squared_karatsuba
     Fp12_2over3over2_model squared_karatsuba() const;
     Fp12_2over3over2_model squared_complex() const;
     Fp12_2over3over2_model& invert();
@@ -107,12 +107,39 @@ public:
     Fp12_2over3over2_model Frobenius_map(unsigned long power) const;
     Fp12_2over3over2_model unitary_inverse() const;
     Fp12_2over3over2_model cyclotomic_squared() const;
+    /**
+     * Karabina's squaring of an element of the cyclotomic subgroup in compressed
+     * form, in which only c0.c1, c0.c2, c1.c0 and c1.c2 are kept: c0.c0 and c1.c1
+     * are copied as they are, and are meaningless once squared. Recover them with
+     * batch_decompress.
+     */
+    Fp12_2over3over2_model cyclotomic_squared_compressed() const;
     Fp12_2over3over2_model sqrt() const; // HAS TO BE A SQUARE (else does not terminate)
 
     Fp12_2over3over2_model mul_by_024(const my_Fp2 &ell_0, const my_Fp2 &ell_VW, const my_Fp2 &ell_VV) const;
     Fp12_2over3over2_model mul_by_045(const my_Fp2 &ell_0, const my_Fp2 &ell_VW, const my_Fp2 &ell_VV) const;
 
+    /**
+     * Products of two lines in the sparse form taken by mul_by_024 (resp. mul_by_045),
+     * which have c1.c2 = 0 (resp. c1.c0 = 0). Multiplying them into the Miller loop
+     * accumulator with mul_by_01234 (resp. mul_by_01245) takes 6 + 17 Fp2
+     * multiplications, not counting those by the non-residue, against 2 * 13 for
+     * mul_by_024 (resp. 2 * 18 for mul_by_045).
+     */
+    static Fp12_2over3over2_model mul_024_by_024(const my_Fp2 &ell_0, const my_Fp2 &ell_VW, const my_Fp2 &ell_VV,
+                                                 const my_Fp2 &other_ell_0, const my_Fp2 &other_ell_VW, const my_Fp2 &other_ell_VV);
+    static Fp12_2over3over2_model mul_045_by_045(const my_Fp2 &ell_0, const my_Fp2 &ell_VW, const my_Fp2 &ell_VV,
+                                                 const my_Fp2 &other_ell_0, const my_Fp2 &other_ell_VW, const my_Fp2 &other_ell_VV);
+    Fp12_2over3over2_model mul_by_01234(const Fp12_2over3over2_model &other) const; // other.c1.c2 must be 0
+    Fp12_2over3over2_model mul_by_01245(const Fp12_2over3over2_model &other) const; // other.c1.c0 must be 0
+
     static my_Fp6 mul_by_non_residue(const my_Fp6 &elt);
+    /**
+     * Decompresses the results of cyclotomic_squared_compressed in place, sharing
+     * one inversion across the batch. The elements must lie in the subgroup of
+     * order p^4 - p^2 + 1 (e.g. be outputs of a final exponentiation).
+     */
+    static void batch_decompress(std::vector<Fp12_2over3over2_model> &vec);
 
     template<mp_size_t m>
     Fp12_2over3over2_model cyclotomic_exp(const bigint<m> &exponent) const;
@@ -10,6 +10,10 @@
 #ifndef FP12_2OVER3OVER2_TCC_
 #define FP12_2OVER3OVER2_TCC_
 
+#include <cassert>
+
+#include <libff/algebra/field_utils/field_utils.hpp>
+
 namespace libff {
 
 using std::size_t;
@@ -17,7 +21,8 @@ using std::size_t;
 template<mp_size_t n, const bigint<n>& modulus>
 Fp6_3over2_model<n, modulus> Fp12_2over3over2_model<n,modulus>::mul_by_non_residue(const Fp6_3over2_model<n, modulus> &elt)
 {
-    return Fp6_3over2_model<n, modulus>(non_residue * elt.c2, elt.c0, elt.c1);
+    /* V * elt, with V^3 = my_Fp6::non_residue (the same as non_residue) */
+    return Fp6_3over2_model<n, modulus>(my_Fp6::mul_by_non_residue(elt.c2), elt.c0, elt.c1);
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
@@ -193,7 +198,9 @@ Fp12_2over3over2_model<n,modulus>& Fp12_2over3over2_model<n,modulus>::operator^=
 template<mp_size_t n, const bigint<n>& modulus>
 Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::squared() const
 {
-    return squared_complex();
+    /* three CH-SQR2 squarings of Fp6, 6 Fp2 multiplications and 9 squarings,
+       against the 12 Fp2 multiplications of the two Fp6 products in squared_complex */
+    return squared_karatsuba();
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
@@ -291,15 +298,15 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_
 
     // t0 + t1*y = (z0 + z1*y)^2 = a^2
     tmp = z0 * z1;
-    t0 = (z0 + z1) * (z0 + my_Fp6::non_residue * z1) - tmp - my_Fp6::non_residue * tmp;
+    t0 = (z0 + z1) * (z0 + my_Fp6::mul_by_non_residue(z1)) - tmp - my_Fp6::mul_by_non_residue(tmp);
     t1 = tmp + tmp;
     // t2 + t3*y = (z2 + z3*y)^2 = b^2
     tmp = z2 * z3;
-    t2 = (z2 + z3) * (z2 + my_Fp6::non_residue * z3) - tmp - my_Fp6::non_residue * tmp;
+    t2 = (z2 + z3) * (z2 + my_Fp6::mul_by_non_residue(z3)) - tmp - my_Fp6::mul_by_non_residue(tmp);
     t3 = tmp + tmp;
     // t4 + t5*y = (z4 + z5*y)^2 = c^2
     tmp = z4 * z5;
-    t4 = (z4 + z5) * (z4 + my_Fp6::non_residue * z5) - tmp - my_Fp6::non_residue * tmp;
+    t4 = (z4 + z5) * (z4 + my_Fp6::mul_by_non_residue(z5)) - tmp - my_Fp6::mul_by_non_residue(tmp);
     t5 = tmp + tmp;
 
     // for A
@@ -316,7 +323,7 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_
     // for B
 
     // z2 = 3 * (xi * t5) + 2 * z2
-    tmp = my_Fp6::non_residue * t5;
+    tmp = my_Fp6::mul_by_non_residue(t5);
     z2 = tmp + z2;
     z2 = z2 + z2;
     z2 = z2 + tmp;
@@ -341,6 +348,107 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_
     return Fp12_2over3over2_model<n,modulus>(my_Fp6(z0,z4,z3),my_Fp6(z2,z1,z5));
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_squared_compressed() const
+{
+    /*
+      Karabina --- Squaring in Cyclotomic Subgroups (eprint 2010/542); Section 3.2,
+      with g0, ..., g5 the coefficients of 1, V, V^2, W, VW, V^2W and xi = my_Fp6::non_residue
+    */
+    const my_Fp2 &g1 = this->c0.c1, &g2 = this->c0.c2, &g3 = this->c1.c0, &g5 = this->c1.c2;
+
+    const my_Fp2 g1sq = g1.squared();
+    const my_Fp2 g2sq = g2.squared();
+    const my_Fp2 g3sq = g3.squared();
+    const my_Fp2 g5sq = g5.squared();
+    const my_Fp2 g1g5 = (g1 + g5).squared() - g1sq - g5sq; // 2 * g1 * g5
+    const my_Fp2 g2g3 = (g2 + g3).squared() - g2sq - g3sq; // 2 * g2 * g3
+
+    my_Fp2 h1, h2, h3, h5, tmp;
+
+    // h1 = 3 * (g3^2 + xi * g2^2) - 2 * g1
+    tmp = g3sq + my_Fp6::mul_by_non_residue(g2sq);
+    h1 = tmp - g1;
+    h1 = h1 + h1;
+    h1 = h1 + tmp;
+
+    // h2 = 3 * (g1^2 + xi * g5^2) - 2 * g2
+    tmp = g1sq + my_Fp6::mul_by_non_residue(g5sq);
+    h2 = tmp - g2;
+    h2 = h2 + h2;
+    h2 = h2 + tmp;
+
+    // h3 = 3 * (2 * xi * g1 * g5) + 2 * g3
+    tmp = my_Fp6::mul_by_non_residue(g1g5);
+    h3 = tmp + g3;
+    h3 = h3 + h3;
+    h3 = h3 + tmp;
+
+    // h5 = 3 * (2 * g2 * g3) + 2 * g5
+    h5 = g2g3 + g5;
+    h5 = h5 + h5;
+    h5 = h5 + g2g3;
+
+    return Fp12_2over3over2_model<n,modulus>(my_Fp6(this->c0.c0, h1, h2), my_Fp6(h3, this->c1.c1, h5));
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+void Fp12_2over3over2_model<n,modulus>::batch_decompress(std::vector<Fp12_2over3over2_model<n,modulus> > &vec)
+{
+    /*
+      Karabina, Theorem 3.1:
+        g4 = (xi * g5^2 + 3 * g1^2 - 2 * g2) / (4 * g3)   if g3 != 0
+        g4 = (2 * g1 * g5) / g2                            if g3 == 0
+        g0 = xi * (2 * g4^2 + g3 * g5 - 3 * g1 * g2) + 1
+      with all the divisions done by one batch_invert. g2 = g3 = 0 only for 1.
+    */
+    std::vector<my_Fp2> numerators, denominators;
+    numerators.reserve(vec.size());
+    denominators.reserve(vec.size());
+    for (const Fp12_2over3over2_model<n,modulus> &el : vec)
+    {
+        const my_Fp2 &g1 = el.c0.c1, &g2 = el.c0.c2, &g3 = el.c1.c0, &g5 = el.c1.c2;
+        if (!g3.is_zero())
+        {
+            const my_Fp2 g1sq = g1.squared();
+            my_Fp2 num = g1sq - g2;
+            num = num + num;
+            num = num + g1sq;
+            numerators.emplace_back(num + my_Fp6::mul_by_non_residue(g5.squared()));
+            const my_Fp2 g3_2 = g3 + g3;
+            denominators.emplace_back(g3_2 + g3_2);
+        }
+        else if (!g2.is_zero())
+        {
+            const my_Fp2 g1g5 = g1 * g5;
+            numerators.emplace_back(g1g5 + g1g5);
+            denominators.emplace_back(g2);
+        }
+    }
+
+    batch_invert(denominators);
+
+    size_t j = 0;
+    for (Fp12_2over3over2_model<n,modulus> &el : vec)
+    {
+        const my_Fp2 &g1 = el.c0.c1, &g2 = el.c0.c2, &g3 = el.c1.c0, &g5 = el.c1.c2;
+        if (g3.is_zero() && g2.is_zero())
+        {
+            el = one();
+            continue;
+        }
+
+        const my_Fp2 g4 = numerators[j] * denominators[j];
+        ++j;
+        const my_Fp2 g1g2 = g1 * g2;
+        my_Fp2 tmp = g4.squared() - g1g2;
+        tmp = tmp + tmp;
+        tmp = tmp - g1g2 + g3 * g5;
+        el.c0.c0 = my_Fp6::mul_by_non_residue(tmp) + my_Fp2::one();
+        el.c1.c1 = g4;
+    }
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_045(const Fp2_model<n, modulus> &ell_0,
                                                                                 const Fp2_model<n, modulus> &ell_VW,
@@ -368,8 +476,8 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_045(
     my_Fp2 t0, t1, t2, t3, t4, t5;
     my_Fp2 tmp1, tmp2;
 
-    tmp1 = my_Fp6::non_residue * x4;
-    tmp2 = my_Fp6::non_residue * x5;
+    tmp1 = my_Fp6::mul_by_non_residue(x4);
+    tmp2 = my_Fp6::mul_by_non_residue(x5);
 
     t0 = x0 * z0 + tmp1 * z4 + tmp2 * z3;
     t1 = x0 * z1 + tmp1 * z5 + tmp2 * z4;
@@ -415,14 +523,14 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(
     // For z.a_.a_ = z0.
     S1 = z1 * x2;
     T3 = S1 + D4;
-    T4 = my_Fp6::non_residue * T3 + D0;
+    T4 = my_Fp6::mul_by_non_residue(T3) + D0;
     z0 = T4;
 
     // For z.a_.b_ = z1
     T3 = z5 * x4;
     S1 = S1 + T3;
     T3 = T3 + D2;
-    T4 = my_Fp6::non_residue * T3;
+    T4 = my_Fp6::mul_by_non_residue(T3);
     T3 = z1 * x0;
     S1 = S1 + T3;
     T4 = T4 + T3;
@@ -440,7 +548,7 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(
     z2 = T3;
     t1 = x2 + x4;
     T3 = t0 * t1 - D2 - D4;
-    T4 = my_Fp6::non_residue * T3;
+    T4 = my_Fp6::mul_by_non_residue(T3);
     T3 = z3 * x0;
     S1 = S1 + T3;
     T4 = T4 + T3;
@@ -449,7 +557,7 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(
     // For z.b_.b_ = z4
     T3 = z5 * x2;
     S1 = S1 + T3;
-    T4 = my_Fp6::non_residue * T3;
+    T4 = my_Fp6::mul_by_non_residue(T3);
     t0 = x0 + x4;
     T3 = t2 * t0 - D0 - D4;
     T4 = T4 + T3;
@@ -464,32 +572,146 @@ Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_024(
 
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_024_by_024(const Fp2_model<n, modulus> &ell_0,
+                                                                                    const Fp2_model<n, modulus> &ell_VW,
+                                                                                    const Fp2_model<n, modulus> &ell_VV,
+                                                                                    const Fp2_model<n, modulus> &other_ell_0,
+                                                                                    const Fp2_model<n, modulus> &other_ell_VW,
+                                                                                    const Fp2_model<n, modulus> &other_ell_VV)
+{
+    /*
+      (x0 + x2*V^2 + x4*VW) * (y0 + y2*V^2 + y4*VW), with W^2 = V and V^3 = xi:
+      6 Fp2 multiplications by Karatsuba, and no VW^2 = V^2*W term
+    */
+    const my_Fp2 &x0 = ell_0, &x2 = ell_VV, &x4 = ell_VW;
+    const my_Fp2 &y0 = other_ell_0, &y2 = other_ell_VV, &y4 = other_ell_VW;
+
+    const my_Fp2 D0 = x0 * y0;
+    const my_Fp2 D2 = x2 * y2;
+    const my_Fp2 D4 = x4 * y4;
+
+    const my_Fp2 z0 = D0 + my_Fp6::mul_by_non_residue(D4);
+    const my_Fp2 z1 = my_Fp6::mul_by_non_residue(D2);
+    const my_Fp2 z2 = (x0 + x2) * (y0 + y2) - D0 - D2;
+    const my_Fp2 z3 = my_Fp6::mul_by_non_residue((x2 + x4) * (y2 + y4) - D2 - D4);
+    const my_Fp2 z4 = (x0 + x4) * (y0 + y4) - D0 - D4;
+
+    return Fp12_2over3over2_model<n,modulus>(my_Fp6(z0, z1, z2), my_Fp6(z3, z4, my_Fp2::zero()));
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_045_by_045(const Fp2_model<n, modulus> &ell_0,
+                                                                                    const Fp2_model<n, modulus> &ell_VW,
+                                                                                    const Fp2_model<n, modulus> &ell_VV,
+                                                                                    const Fp2_model<n, modulus> &other_ell_0,
+                                                                                    const Fp2_model<n, modulus> &other_ell_VW,
+                                                                                    const Fp2_model<n, modulus> &other_ell_VV)
+{
+    /*
+      (x0 + x4*VW + x5*V^2W) * (y0 + y4*VW + y5*V^2W), with W^2 = V and V^3 = xi:
+      6 Fp2 multiplications by Karatsuba, and no W term
+    */
+    const my_Fp2 &x0 = ell_VW, &x4 = ell_0, &x5 = ell_VV;
+    const my_Fp2 &y0 = other_ell_VW, &y4 = other_ell_0, &y5 = other_ell_VV;
+
+    const my_Fp2 D0 = x0 * y0;
+    const my_Fp2 D4 = x4 * y4;
+    const my_Fp2 D5 = x5 * y5;
+
+    const my_Fp2 z0 = D0 + my_Fp6::mul_by_non_residue(D4);
+    const my_Fp2 z1 = my_Fp6::mul_by_non_residue((x4 + x5) * (y4 + y5) - D4 - D5);
+    const my_Fp2 z2 = my_Fp6::mul_by_non_residue(D5);
+    const my_Fp2 z4 = (x0 + x4) * (y0 + y4) - D0 - D4;
+    const my_Fp2 z5 = (x0 + x5) * (y0 + y5) - D0 - D5;
+
+    return Fp12_2over3over2_model<n,modulus>(my_Fp6(z0, z1, z2), my_Fp6(my_Fp2::zero(), z4, z5));
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_01234(const Fp12_2over3over2_model<n,modulus> &other) const
+{
+    /* operator* with B = other.c1 = B0 + B1*V, multiplied by mul_by_01 */
+    assert(other.c1.c2.is_zero());
+    const my_Fp6 &A = other.c0, &a = this->c0, &b = this->c1;
+    const my_Fp2 &B0 = other.c1.c0, &B1 = other.c1.c1;
+
+    const my_Fp6 aA = a * A;
+    const my_Fp6 bB = b.mul_by_01(B0, B1);
+
+    return Fp12_2over3over2_model<n,modulus>(aA + Fp12_2over3over2_model<n, modulus>::mul_by_non_residue(bB),
+                                             (a + b) * my_Fp6(A.c0 + B0, A.c1 + B1, A.c2) - aA - bB);
+}
+
+template<mp_size_t n, const bigint<n>& modulus>
+Fp12_2over3over2_model<n,modulus> Fp12_2over3over2_model<n,modulus>::mul_by_01245(const Fp12_2over3over2_model<n,modulus> &other) const
+{
+    /* operator* with B = other.c1 = (B1 + B2*V) * V, multiplied by mul_by_01 */
+    assert(other.c1.c0.is_zero());
+    const my_Fp6 &A = other.c0, &a = this->c0, &b = this->c1;
+    const my_Fp2 &B1 = other.c1.c1, &B2 = other.c1.c2;
+
+    const my_Fp6 aA = a * A;
+    const my_Fp6 bB = Fp12_2over3over2_model<n, modulus>::mul_by_non_residue(b.mul_by_01(B1, B2));
+
+    return Fp12_2over3over2_model<n,modulus>(aA + Fp12_2over3over2_model<n, modulus>::mul_by_non_residue(bB),
+                                             (a + b) * my_Fp6(A.c0, A.c1 + B1, A.c2 + B2) - aA - bB);
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 template<mp_size_t m>
 Fp12_2over3over2_model<n, modulus> Fp12_2over3over2_model<n,modulus>::cyclotomic_exp(const bigint<m> &exponent) const
 {
-    Fp12_2over3over2_model<n,modulus> res = Fp12_2over3over2_model<n,modulus>::one();
+    /*
+      Karabina's squarings leave the multiplications of the binary NAF to the
+      end, after one batched decompression, so they cannot use a window. A
+      compressed squaring saves about a quarter of a multiplication over
+      cyclotomic_squared, and each nonzero digit costs a multiplication and about
+      a third of one for its decompression, against about a quarter of a
+      multiplication per bit for the windows of cyclotomic_power: the sparse
+      exponents of final exponentiations (e.g. the BLS12-381 z) favour Karabina,
+      dense ones (e.g. the alt_bn128 z) do not.
+    */
+    const std::vector<long> naf = find_wnaf(1, exponent);
+    long top = naf.size() - 1;
+    while (top >= 0 && naf[top] == 0)
+    {
+        --top;
+    }
+    long weight = 0;
+    for (long i = 0; i <= top; ++i)
+    {
+        weight += (naf[i] != 0 ? 1 : 0);
+    }
+    if (8 * weight >= 3 * top)
+    {
+        return cyclotomic_power(*this, exponent);
+    }
 
-    bool found_one = false;
-    for (long i = m-1; i >= 0; --i)
+    /* base^(+-2^i) for the nonzero digits naf[i] with i > 0 */
+    std::vector<Fp12_2over3over2_model<n,modulus> > factors;
+    Fp12_2over3over2_model<n,modulus> x = *this;
+    for (long i = 1; i <= top; ++i)
     {
-        for (long j = GMP_NUMB_BITS - 1; j >= 0; --j)
+        x = x.cyclotomic_squared_compressed();
+        if (naf[i] != 0)
         {
-            if (found_one)
-            {
-                res = res.cyclotomic_squared();
-            }
-
-            static const mp_limb_t one = 1;
-            if (exponent.data[i] & (one<<j))
-            {
-                found_one = true;
-                res = res * (*this);
-            }
+            factors.emplace_back(naf[i] > 0 ? x : x.unitary_inverse());
         }
     }
+    batch_decompress(factors);
 
-    return res;
+    /* top > 0 here, so factors is not empty */
+    Fp12_2over3over2_model<n,modulus> result = factors[0];
+    if (naf[0] != 0)
+    {
+        result = result * (naf[0] > 0 ? *this : this->unitary_inverse());
+    }
+    for (size_t i = 1; i < factors.size(); ++i)
+    {
+        result = result * factors[i];
+    }
+    return result;
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
@@ -9,6 +9,7 @@
 
 #ifndef FP2_HPP_
 #define FP2_HPP_
+#include <type_traits>
 #include <vector>
 
 #include <libff/algebra/fields/prime_base/fp.hpp>
@@ -24,6 +25,16 @@ std::ostream& operator<<(std::ostream &, const Fp2_model<n, modulus> &);
 template<mp_size_t n, const bigint<n>& modulus>
 std::istream& operator>>(std::istream &, Fp2_model<n, modulus> &);
 
+/**
+ * Whether Fp2_model<n, modulus>::non_residue is -1, i.e. Fp2 = Fp[U]/(U^2+1).
+ * Curves with such a quadratic extension specialize this next to their
+ * Fp_params (see alt_bn128_fields.hpp), and multiplication and squaring then
+ * skip the multiplications by the non-residue. The runtime non_residue must
+ * still be set, to the same value.
+ */
+template<mp_size_t n, const bigint<n>& modulus>
+struct Fp2_non_residue_is_minus_one : std::false_type {};
+
 /**
  * Arithmetic in the field F[p^2].
  *
@@ -52,6 +63,7 @@ public:
     static Fp2_model<n, modulus> nqr; // a quadratic nonresidue in Fp2
     static Fp2_model<n, modulus> nqr_to_t; // nqr^t
     static my_Fp Frobenius_coeffs_c1[2]; // non_residue^((modulus^i-1)/2) for i=0,1
+    static constexpr bool non_residue_is_minus_one = Fp2_non_residue_is_minus_one<n, modulus>::value; // see Fp2_non_residue_is_minus_one
 
     my_Fp c0, c1;
     Fp2_model() {};
@@ -99,7 +99,7 @@ Fp2_model<n,modulus> Fp2_model<n,modulus>::operator*(const Fp2_model<n,modulus>
     const my_Fp aA = a * A;
     const my_Fp bB = b * B;
 
-    return Fp2_model<n,modulus>(aA + non_residue * bB,
+    return Fp2_model<n,modulus>(non_residue_is_minus_one ? aA - bB : aA + non_residue * bB,
                                 (a + b)*(A+B) - aA - bB);
 }
 
@@ -184,7 +184,7 @@ Fp2_model<n,modulus> Fp2_model<n,modulus>::squared_karatsuba() const
     const my_Fp asq = a.squared();
     const my_Fp bsq = b.squared();
 
-    return Fp2_model<n,modulus>(asq + non_residue * bsq,
+    return Fp2_model<n,modulus>(non_residue_is_minus_one ? asq - bsq : asq + non_residue * bsq,
                                 (a + b).squared() - asq - bsq);
 }
 
@@ -198,7 +198,14 @@ Fp2_model<n,modulus> Fp2_model<n,modulus>::squared_complex() const
     const my_Fp &a = this->c0, &b = this->c1;
     const my_Fp ab = a * b;
 
-    return Fp2_model<n,modulus>((a + b) * (a + non_residue * b) - ab - non_residue * ab,
+    if (non_residue_is_minus_one)
+    {
+        /* (a + b) * (a - b) = a^2 - b^2, and the non-residue terms vanish */
+        return Fp2_model<n,modulus>((a + b) * (a - b),
+                                    ab + ab);
+    }
+    /* a^2 + non_residue * b^2, with one reduction for the sum */
+    return Fp2_model<n,modulus>((a.squared_unreduced() + non_residue.mul_unreduced(b.squared())).reduce(),
                                 ab + ab);
 }
 
@@ -310,35 +310,7 @@ template<mp_size_t n, const bigint<n>& modulus>
 template<mp_size_t m>
 Fp6_2over3_model<n, modulus> Fp6_2over3_model<n,modulus>::cyclotomic_exp(const bigint<m> &exponent) const
 {
-    Fp6_2over3_model<n,modulus> res = Fp6_2over3_model<n,modulus>::one();
-    Fp6_2over3_model<n,modulus> this_inverse = this->unitary_inverse();
-
-    bool found_nonzero = false;
-    std::vector<long> NAF = find_wnaf(1, exponent);
-
-    for (long i = static_cast<long>(NAF.size() - 1); i >= 0; --i)
-    {
-        if (found_nonzero)
-        {
-            res = res.cyclotomic_squared();
-        }
-
-        if (NAF[i] != 0)
-        {
-            found_nonzero = true;
-
-            if (NAF[i] > 0)
-            {
-                res = res * (*this);
-            }
-            else
-            {
-                res = res * this_inverse;
-            }
-        }
-    }
-
-    return res;
+    return cyclotomic_power(*this, exponent);
 }
 
 template<mp_size_t n, const bigint<n>& modulus>
@@ -9,6 +9,7 @@
 
 #ifndef FP6_3OVER2_HPP_
 #define FP6_3OVER2_HPP_
+#include <type_traits>
 #include <vector>
 
 #include <libff/algebra/fields/prime_base/fp.hpp>
@@ -25,6 +26,16 @@ std::ostream& operator<<(std::ostream &, const Fp6_3over2_model<n, modulus> &);
 template<mp_size_t n, const bigint<n>& modulus>
 std::istream& operator>>(std::istream &, Fp6_3over2_model<n, modulus> &);
 
+/**
+ * The small integer k if Fp6_3over2_model<n, modulus>::non_residue is k + U in
+ * Fp2 = Fp[U]/(U^2+1), and 0 otherwise. Curves with such a non-residue
+ * specialize this next to Fp2_non_residue_is_minus_one, and mul_by_non_residue
+ * then takes 2 Fp multiplications (none for k = 1) instead of an Fp2
+ * multiplication. The runtime non_residue must still be set, to the same value.
+ */
+template<mp_size_t n, const bigint<n>& modulus>
+struct Fp6_3over2_non_residue_c0 : std::integral_constant<unsigned, 0> {};
+
 /**
  * Arithmetic in the finite field F[(p^2)^3].
  *
@@ -53,6 +64,7 @@ public:
     static Fp6_3over2_model<n, modulus> nqr; // a quadratic nonresidue in Fp6
     static Fp6_3over2_model<n, modulus> nqr_to_t; // nqr^t
     static my_Fp2 non_residue;
+    static constexpr unsigned non_residue_c0 = Fp6_3over2_non_residue_c0<n, modulus>::value; // see Fp6_3over2_non_residue_c0
     static my_Fp2 Frobenius_coeffs_c1[6]; // non_residue^((modulus^i-1)/3)   for i=0,1,2,3,4,5
     static my_Fp2 Frobenius_coeffs_c2[6]; // non_residue^((2*modulus^i-2)/3) for i=0,1,2,3,4,5
 
@@ -94,6 +106,8 @@ public:
     template<mp_size_t m>
     Fp6_3over2_model operator^(const bigint<m> &other) const;
     Fp6_3over2_model operator-() const;
+    /** Multiplication by B0 + B1*V, i.e. by an element with c2 = 0 */
+    Fp6_3over2_model mul_by_01(const my_Fp2 &B0, const my_Fp2 &B1) const;
 
     Fp6_3over2_model& square();
     Fp6_3over2_model squared() const;
@@ -18,6 +18,17 @@ using std::size_t;
 template<mp_size_t n, const bigint<n>& modulus>
 Fp2_model<n, modulus> Fp6_3over2_model<n,modulus>::mul_by_non_residue(const Fp2_model<n, modulus> &elt)
 {
+    static_assert(non_residue_c0 == 0 || my_Fp2::non_residue_is_minus_one, "non_residue_c0 needs U^2 = -1");
+    if (non_residue_c0 == 1)
+    {
+        /* (a0 + a1*U) * (1 + U) = (a0 - a1) + (a0 + a1)*U */
+        return Fp2_model<n, modulus>(elt.c0 - elt.c1, elt.c0 + elt.c1);
+    }
+    if (non_residue_c0 != 0)
+    {
+        /* (a0 + a1*U) * (k + U) = (k*a0 - a1) + (a0 + k*a1)*U: 2 Fp multiplications instead of 3 */
+        return Fp2_model<n, modulus>(non_residue.c0 * elt.c0 - elt.c1, elt.c0 + non_residue.c0 * elt.c1);
+    }
     return Fp2_model<n, modulus>(non_residue * elt);
 }
 
@@ -125,6 +136,19 @@ Fp6_3over2_model<n,modulus> Fp6_3over2_model<n,modulus>::operator*(const Fp6_3ov
                                        (a+c)*(A+C)-aA+bB-cC);
 }
 
+template<mp_size_t n, const bigint<n>& modulus>
+Fp6_3over2_model<n,modulus> Fp6_3over2_model<n,modulus>::mul_by_01(const my_Fp2 &B0, const my_Fp2 &B1) const
+{
+    /* operator* with C = 0: 5 Fp2 multiplications instead of 6 */
+    const my_Fp2 &a = this->c0, &b = this->c1, &c = this->c2;
+    const my_Fp2 aA = a*B0;
+    const my_Fp2 bB = b*B1;
+
+    return Fp6_3over2_model<n,modulus>(aA + Fp6_3over2_model<n,modulus>::mul_by_non_residue(c*B1),
+                                       (a+b)*(B0+B1)-aA-bB,
+                                       c*B0+bB);
+}
+
 template<mp_size_t n, const bigint<n>& modulus>
 Fp6_3over2_model<n,modulus> Fp6_3over2_model<n,modulus>::operator-() const
 {
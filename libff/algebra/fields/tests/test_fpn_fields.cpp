@@ -10,6 +10,8 @@
  *             and contributors (see AUTHORS).
  * @copyright  MIT license (see LICENSE file)
  *****************************************************************************/
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include <libff/algebra/curves/alt_bn128/alt_bn128_pp.hpp>
@@ -20,11 +22,20 @@
 #include <libff/algebra/curves/edwards/edwards_pp.hpp>
 #include <libff/algebra/curves/mnt/mnt4/mnt4_pp.hpp>
 #include <libff/algebra/curves/mnt/mnt6/mnt6_pp.hpp>
+#include <libff/algebra/field_utils/field_utils.hpp>
+#include <libff/algebra/scalar_multiplication/multiexp.hpp>
+#include <libff/common/chacha20_rng.hpp>
 #include <libff/common/profiling.hpp>
+#include <libff/common/rng.hpp>
+#include <libff/common/sha512_multi.hpp>
 #include <libff/common/utils.hpp>
 
 using namespace libff;
 
+/* prime fields of one and two limbs, which no curve uses; see init_small_field() */
+bigint<1> goldilocks_modulus("18446744069414584321"); // 2^64 - 2^32 + 1
+bigint<2> modulus_2_128_minus_159("340282366920938463463374607431768211297");
+
 class FpnFieldsTest: public ::testing::Test {
 public:
     FpnFieldsTest()
@@ -118,6 +129,57 @@ void test_two_squarings()
     EXPECT_EQ(a_squared, a.squared_karatsuba());
 }
 
+template<typename Fp2T>
+void test_Fp2_non_residue()
+{
+    typedef typename Fp2T::my_Fp FpT;
+    if (Fp2T::non_residue_is_minus_one)
+    {
+        EXPECT_EQ(Fp2T::non_residue, -FpT::one());
+    }
+
+    const Fp2T minus_one = -Fp2T::one();
+    EXPECT_EQ(minus_one * minus_one, Fp2T::one());
+    EXPECT_EQ(minus_one.squared(), Fp2T::one());
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        const Fp2T a = Fp2T::random_element();
+        const Fp2T b = (i == 0 ? minus_one : Fp2T::random_element());
+
+        /* schoolbook, with every product reduced */
+        const Fp2T ab(a.c0 * b.c0 + Fp2T::non_residue * (a.c1 * b.c1), a.c0 * b.c1 + a.c1 * b.c0);
+        const Fp2T a_squared(a.c0 * a.c0 + Fp2T::non_residue * (a.c1 * a.c1), a.c0 * a.c1 + a.c1 * a.c0);
+        EXPECT_EQ(a * b, ab);
+        EXPECT_EQ(a.squared(), a_squared);
+    }
+}
+
+template<typename Fp3T>
+void test_Fp3_mul()
+{
+    const typename Fp3T::my_Fp &nr = Fp3T::non_residue;
+    const Fp3T minus_one = -Fp3T::one();
+    EXPECT_EQ(minus_one * minus_one, Fp3T::one());
+    EXPECT_EQ(minus_one.squared(), Fp3T::one());
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        const Fp3T a = Fp3T::random_element();
+        const Fp3T b = (i == 0 ? minus_one : Fp3T::random_element());
+
+        /* schoolbook, with every product reduced */
+        const Fp3T ab(a.c0 * b.c0 + nr * (a.c1 * b.c2 + a.c2 * b.c1),
+                      a.c0 * b.c1 + a.c1 * b.c0 + nr * (a.c2 * b.c2),
+                      a.c0 * b.c2 + a.c1 * b.c1 + a.c2 * b.c0);
+        const Fp3T a_squared(a.c0 * a.c0 + nr * (a.c1 * a.c2 + a.c2 * a.c1),
+                             a.c0 * a.c1 + a.c1 * a.c0 + nr * (a.c2 * a.c2),
+                             a.c0 * a.c2 + a.c1 * a.c1 + a.c2 * a.c0);
+        EXPECT_EQ(a * b, ab);
+        EXPECT_EQ(a.squared(), a_squared);
+    }
+}
+
 template<typename FieldT>
 void test_unitary_inverse()
 {
@@ -171,6 +233,588 @@ void test_cyclotomic_squaring<Fqk<mnt6_pp> >()
     EXPECT_EQ(beta.cyclotomic_squared(), beta.squared());
 }
 
+/* a random exponent of the given number of bits */
+template<mp_size_t m>
+bigint<m> random_exponent(const size_t bits)
+{
+    bigint<m> e;
+    e.randomize();
+    for (size_t k = 0; k < m; k++)
+    {
+        if (k * GMP_NUMB_BITS >= bits)
+        {
+            e.data[k] = 0;
+        }
+        else if ((k + 1) * GMP_NUMB_BITS > bits)
+        {
+            e.data[k] &= (mp_limb_t(1) << (bits - k * GMP_NUMB_BITS)) - 1;
+        }
+    }
+    return e;
+}
+
+template<typename FieldT>
+void test_power()
+{
+    const FieldT a = FieldT::random_element();
+    for (size_t bits = 0; bits <= 3 * GMP_NUMB_BITS; bits += 5)
+    {
+        const bigint<3> e = random_exponent<3>(bits);
+
+        /* plain square-and-multiply */
+        FieldT expected = FieldT::one();
+        for (long i = e.max_bits() - 1; i >= 0; --i)
+        {
+            expected = expected * expected;
+            if (e.test_bit(i))
+            {
+                expected = expected * a;
+            }
+        }
+        EXPECT_EQ(a ^ e, expected);
+    }
+}
+
+template<typename ppT>
+void test_cyclotomic_power()
+{
+    const GT<ppT> beta = ppT::final_exponentiation(random_element_non_zero<Fqk<ppT> >());
+    for (size_t bits = 0; bits <= 2 * GMP_NUMB_BITS; bits += 9)
+    {
+        const bigint<2> e = random_exponent<2>(bits);
+        EXPECT_EQ(beta.cyclotomic_exp(e), beta ^ e);
+    }
+    /* sparse, like the BLS12-381 parameter */
+    const bigint<1> sparse("15132376222941642752");
+    EXPECT_EQ(beta.cyclotomic_exp(sparse), beta ^ sparse);
+}
+
+template<typename ppT>
+void test_cyclotomic_squaring_compressed()
+{
+    typedef Fqk<ppT> FieldT;
+    const FieldT beta = ppT::final_exponentiation(random_element_non_zero<FieldT>());
+
+    /* beta^(2^k) for k = 0, ..., 9, and 1, which decompresses on its own branch */
+    std::vector<FieldT> compressed(1, beta), expected(1, beta);
+    for (size_t k = 1; k < 10; ++k)
+    {
+        compressed.emplace_back(compressed.back().cyclotomic_squared_compressed());
+        expected.emplace_back(expected.back().cyclotomic_squared());
+    }
+    compressed.emplace_back(FieldT::one().cyclotomic_squared_compressed());
+    expected.emplace_back(FieldT::one());
+    /* a conjugate, as for the negative digits of cyclotomic_exp */
+    compressed.emplace_back(compressed[5].unitary_inverse());
+    expected.emplace_back(expected[5].unitary_inverse());
+
+    FieldT::batch_decompress(compressed);
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(compressed[i], expected[i]);
+    }
+
+    std::vector<FieldT> empty;
+    FieldT::batch_decompress(empty);
+    EXPECT_TRUE(empty.empty());
+}
+
+template<typename FieldT, typename ScalarT>
+void test_field_multi_exp(const size_t length, const size_t chunks)
+{
+    std::vector<FieldT> bases = random_vector<FieldT>(length);
+    std::vector<ScalarT> exponents = random_vector<ScalarT>(length);
+    if (length > 2)
+    {
+        exponents[1] = ScalarT::zero();
+        exponents[2] = ScalarT::one();
+    }
+
+    FieldT expected = FieldT::one();
+    for (size_t i = 0; i < length; i++)
+    {
+        expected *= bases[i] ^ exponents[i].as_bigint();
+    }
+    const FieldT result = field_multi_exp<FieldT, ScalarT>(bases.begin(), bases.end(), exponents.begin(), exponents.end(), chunks);
+    EXPECT_EQ(result, expected);
+}
+
+template<typename ppT>
+void test_cyclotomic_multi_exp(const size_t length)
+{
+    std::vector<GT<ppT> > bases(length);
+    std::vector<Fr<ppT> > exponents = random_vector<Fr<ppT> >(length);
+    GT<ppT> expected = GT<ppT>::one();
+    for (size_t i = 0; i < length; i++)
+    {
+        bases[i] = ppT::final_exponentiation(random_element_non_zero<Fqk<ppT> >());
+        expected *= bases[i] ^ exponents[i].as_bigint();
+    }
+    const GT<ppT> result = cyclotomic_multi_exp<GT<ppT>, Fr<ppT> >(bases.begin(), bases.end(), exponents.begin(), exponents.end(), 1);
+    EXPECT_EQ(result, expected);
+}
+
+template<typename FieldT>
+void test_inner_product()
+{
+    for (const size_t length : { 0, 1, 7, 5000 })
+    {
+        const std::vector<FieldT> a = random_vector<FieldT>(length);
+        std::vector<FieldT> b = random_vector<FieldT>(length);
+        if (length > 1)
+        {
+            b[0] = -FieldT::one(); // the largest product
+            b[1] = -FieldT::one();
+        }
+
+        FieldT expected = FieldT::zero();
+        for (size_t i = 0; i < length; i++)
+        {
+            expected += a[i] * b[i];
+        }
+        const FieldT result = inner_product<FieldT>(a.begin(), a.end(), b.begin(), b.end());
+        EXPECT_EQ(result, expected);
+    }
+}
+
+template<typename FieldT>
+void test_mulx_adx()
+{
+    const bool saved = use_mulx_adx;
+    for (size_t i = 0; i < 100; i++)
+    {
+        /* -1 has the largest representative, for the carries of the squaring */
+        const FieldT a = (i == 0 ? -FieldT::one() : FieldT::random_element());
+        const FieldT b = FieldT::random_element();
+
+        use_mulx_adx = true;
+        const FieldT ab_mulx = a * b;
+        const FieldT a_sq_mulx = a.squared();
+
+        use_mulx_adx = false;
+        EXPECT_EQ(ab_mulx, a * b);
+        EXPECT_EQ(a_sq_mulx, a.squared());
+    }
+    use_mulx_adx = saved;
+}
+
+template<typename FieldT>
+void test_lazy_reduction()
+{
+    const FieldT minus_one = -FieldT::one();
+    EXPECT_EQ(minus_one.mul_unreduced(minus_one).reduce(), FieldT::one());
+    EXPECT_EQ(minus_one.squared_unreduced().reduce(), FieldT::one());
+    EXPECT_EQ(FieldT::zero().squared_unreduced().reduce(), FieldT::zero());
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        const FieldT a = FieldT::random_element();
+        const FieldT b = FieldT::random_element();
+        const FieldT c = FieldT::random_element();
+        const FieldT d = FieldT::random_element();
+
+        EXPECT_EQ(a.mul_unreduced(b).reduce(), a * b);
+        EXPECT_EQ(a.squared_unreduced().reduce(), a.squared());
+        EXPECT_EQ((a.mul_unreduced(b) + c.mul_unreduced(d)).reduce(), a * b + c * d);
+        EXPECT_EQ((a.mul_unreduced(b) - c.mul_unreduced(d)).reduce(), a * b - c * d);
+
+        /* chained additions and subtractions must stay in range */
+        auto acc = a.mul_unreduced(b);
+        FieldT expected = a * b;
+        for (size_t j = 0; j < 10; j++)
+        {
+            acc -= c.mul_unreduced(d);
+            expected -= c * d;
+            acc += minus_one.squared_unreduced();
+            expected += FieldT::one();
+        }
+        EXPECT_EQ(acc.reduce(), expected);
+    }
+}
+
+template<typename FieldT>
+void test_addition_chain()
+{
+    const mp_size_t n = FieldT::num_limbs;
+    bigint<n> p_minus_2 = FieldT::field_char();
+    mpn_sub_1(p_minus_2.data, p_minus_2.data, n, 2);
+
+    const addition_chain euler_chain(FieldT::euler);
+    const addition_chain fermat_chain(p_minus_2);
+    const addition_chain small_chain(bigint<1>(1000003ul));
+    const addition_chain one_chain(bigint<1>(1ul));
+    const addition_chain zero_chain(bigint<1>(0ul));
+    EXPECT_LT(euler_chain.num_operations(), FieldT::euler.num_bits() * 5 / 4);
+
+    for (size_t i = 0; i < 10; i++)
+    {
+        const FieldT a = random_element_non_zero<FieldT>();
+        const FieldT a_euler = euler_chain.evaluate(a);
+        EXPECT_TRUE(a_euler == FieldT::one() || a_euler == -FieldT::one());
+        EXPECT_EQ(a_euler, a ^ FieldT::euler);
+        EXPECT_EQ(euler_chain.evaluate(a.squared()), FieldT::one());
+        EXPECT_EQ(fermat_chain.evaluate(a), a.inverse());
+        EXPECT_EQ(small_chain.evaluate(a), a ^ 1000003);
+        EXPECT_EQ(one_chain.evaluate(a), a);
+        EXPECT_EQ(zero_chain.evaluate(a), FieldT::one());
+
+        const FieldT a_sq = a.squared();
+        const FieldT a_sq_sqrt = a_sq.sqrt();
+        EXPECT_TRUE(a_sq_sqrt == a || a_sq_sqrt == -a);
+    }
+}
+
+template<typename FieldT>
+void test_sqrt_table()
+{
+    const sqrt_table<FieldT> table;
+    EXPECT_EQ(table.sqrt(FieldT::zero()), FieldT::zero());
+    EXPECT_EQ(table.sqrt(FieldT::one()).squared(), FieldT::one());
+    /* a square root of unity of order 2^(s-1), whose logarithm has every digit set */
+    const FieldT root = FieldT::nqr_to_t.squared();
+    EXPECT_EQ(table.sqrt(root).squared(), root);
+
+    for (size_t i = 0; i < 10; i++)
+    {
+        const FieldT a = FieldT::random_element();
+        const FieldT a_sq = a.squared();
+        const FieldT a_sq_sqrt = table.sqrt(a_sq);
+        EXPECT_TRUE(a_sq_sqrt == a || a_sq_sqrt == -a);
+        EXPECT_EQ(a_sq.sqrt().squared(), a_sq);
+    }
+}
+
+template<typename FieldT>
+void test_legendre()
+{
+    EXPECT_EQ(FieldT::zero().legendre(), 0);
+    EXPECT_EQ(FieldT::one().legendre(), 1);
+    EXPECT_EQ(FieldT::nqr.legendre(), -1);
+    EXPECT_FALSE(FieldT::nqr.is_square());
+
+    std::vector<FieldT> vec;
+    for (size_t i = 0; i < 20; i++)
+    {
+        vec.emplace_back(FieldT::random_element());
+    }
+    vec.emplace_back(FieldT::zero());
+    const std::vector<int> symbols = batch_legendre(vec);
+
+    for (size_t i = 0; i < vec.size(); i++)
+    {
+        const FieldT a_euler = vec[i] ^ FieldT::euler;
+        const int expected = vec[i].is_zero() ? 0 : (a_euler == FieldT::one() ? 1 : -1);
+        EXPECT_EQ(vec[i].legendre(), expected);
+        EXPECT_EQ(symbols[i], expected);
+        EXPECT_EQ(vec[i].is_square(), expected != -1);
+        EXPECT_EQ(vec[i].squared().legendre(), vec[i].is_zero() ? 0 : 1);
+    }
+}
+
+template<mp_size_t n>
+bigint<n> limbs_to_bigint(const mp_limb_t (&limbs)[n])
+{
+    bigint<n> result;
+    for (mp_size_t i = 0; i < n; i++)
+    {
+        result.data[i] = limbs[i];
+    }
+    return result;
+}
+
+template<typename FieldT, typename params>
+void test_constexpr_params()
+{
+    const bool is_constexpr = params::is_constexpr;
+    const mp_limb_t inv = params::inv;
+    EXPECT_TRUE(is_constexpr);
+    EXPECT_EQ(limbs_to_bigint(params::modulus), FieldT::field_char());
+    EXPECT_EQ(inv, FieldT::inv);
+}
+
+template<typename FieldT>
+void test_redundant_representation()
+{
+    const bool is_redundant = FieldT::is_redundant;
+    bigint<FieldT::num_limbs> two_p;
+    mpn_lshift(two_p.data, FieldT::mod.data, FieldT::num_limbs, 1);
+
+    size_t num_above_p = 0;
+    for (size_t i = 0; i < 100; i++)
+    {
+        const FieldT a = FieldT::random_element(), b = FieldT::random_element();
+        FieldT x = a * b + a - b;
+        x = x.squared() - (-a) * x;
+
+        /* representatives stay below 2p (below p unless redundant) */
+        const bigint<FieldT::num_limbs> canonical = x.canonical_mont_repr();
+        EXPECT_LT(canonical, FieldT::mod);
+        EXPECT_LT(x.mont_repr, is_redundant ? two_p : FieldT::mod);
+        if (!(x.mont_repr < FieldT::mod))
+        {
+            ++num_above_p;
+        }
+        if (!is_redundant)
+        {
+            EXPECT_EQ(x.mont_repr, canonical);
+            continue;
+        }
+
+        /* the other representative of x behaves the same */
+        FieldT y;
+        mpn_add_n(y.mont_repr.data, canonical.data, FieldT::mod.data, FieldT::num_limbs);
+        EXPECT_EQ(y, x);
+        EXPECT_FALSE(y != x);
+        EXPECT_EQ(y.as_bigint(), x.as_bigint());
+        EXPECT_EQ(y.to_words(), x.to_words());
+        EXPECT_EQ(y.legendre(), x.legendre());
+        EXPECT_EQ(y.inverse(), x.inverse());
+        EXPECT_EQ(y.squared().sqrt().squared(), x.squared());
+        EXPECT_EQ(-y, -x);
+        EXPECT_EQ(y - x, FieldT::zero());
+        std::stringstream ss;
+        ss << y;
+        FieldT z;
+        ss >> z;
+        EXPECT_EQ(z, x);
+    }
+    if (is_redundant)
+    {
+        EXPECT_GT(num_above_p, 0u);
+
+        FieldT p;
+        p.mont_repr = FieldT::mod;
+        EXPECT_TRUE(p.is_zero());
+        EXPECT_EQ(p, FieldT::zero());
+        EXPECT_EQ(p.as_bigint(), bigint<FieldT::num_limbs>(0ul));
+        EXPECT_TRUE((-p).is_zero());
+    }
+    else
+    {
+        EXPECT_EQ(num_above_p, 0u);
+    }
+}
+
+template<typename FieldT>
+void test_SHA512_rng_batch()
+{
+    const uint64_t start = 12345;
+    const size_t count = 1030; // more than one chunk, not a multiple of the lane count
+    const size_t max_lanes = sha512_multi_lanes;
+    for (size_t lanes = 1; lanes <= max_lanes; lanes *= 2)
+    {
+        sha512_multi_lanes = lanes;
+        const std::vector<FieldT> batch = SHA512_rng_batch<FieldT>(start, count);
+        ASSERT_EQ(batch.size(), count);
+        for (size_t i = 0; i < count; i++)
+        {
+            EXPECT_EQ(batch[i], SHA512_rng<FieldT>(start + i));
+        }
+    }
+    sha512_multi_lanes = max_lanes;
+    EXPECT_TRUE(SHA512_rng_batch<FieldT>(start, 0).empty());
+}
+
+template<typename FieldT>
+void test_inverse()
+{
+    const FieldT special[] = {FieldT::one(), -FieldT::one(), FieldT(2), -FieldT(2), FieldT::multiplicative_generator};
+    for (const FieldT &a : special)
+    {
+        EXPECT_EQ(a * a.inverse(), FieldT::one());
+        EXPECT_EQ(a.inverse_constant_time(), a.inverse());
+    }
+    for (size_t i = 0; i < 100; i++)
+    {
+        const FieldT a = FieldT::random_element();
+        const FieldT a_inv = a.inverse();
+        EXPECT_EQ(a * a_inv, FieldT::one());
+        EXPECT_EQ(a_inv.inverse(), a);
+        EXPECT_EQ(a.inverse_constant_time(), a_inv);
+    }
+}
+
+template<typename FieldT>
+void test_batch_invert()
+{
+    /* odd and even lengths, and enough elements for several chunks */
+    const size_t sizes[] = {0, 1, 2, 3, 4100};
+    for (const size_t size : sizes)
+    {
+        std::vector<FieldT> v(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            v[i] = random_element_non_zero<FieldT>();
+        }
+        std::vector<FieldT> v_inv = v;
+        batch_invert(v_inv);
+        for (size_t i = 0; i < size; i++)
+        {
+            EXPECT_EQ(v_inv[i], v[i].inverse());
+        }
+    }
+}
+
+template<typename FieldT>
+void test_batch_arithmetic()
+{
+    const size_t sizes[] = {0, 1, 7, 8, 9, 100};
+    for (const size_t size : sizes)
+    {
+        std::vector<FieldT> a(size), b(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            a[i] = FieldT::random_element();
+            b[i] = (i % 5 == 0 ? -FieldT::one() : FieldT::random_element());
+        }
+        const FieldT c = FieldT::random_element();
+
+        std::vector<FieldT> sum(a), diff(a), prod(a), sq(b), scaled(a);
+        batch_add(sum, b);
+        batch_sub(diff, b);
+        batch_mul(prod, b);
+        batch_square(sq);
+        batch_mul_scalar(scaled, c);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            EXPECT_EQ(sum[i], a[i] + b[i]);
+            EXPECT_EQ(diff[i], a[i] - b[i]);
+            EXPECT_EQ(prod[i], a[i] * b[i]);
+            EXPECT_EQ(sq[i], b[i].squared());
+            EXPECT_EQ(scaled[i], a[i] * c);
+        }
+    }
+}
+
+template<typename FieldT>
+void test_bigint_conversion()
+{
+    const mp_size_t n = FieldT::num_limbs;
+    const size_t sizes[] = {0, 1, 7, 9, 5000};
+    for (const size_t size : sizes)
+    {
+        std::vector<FieldT> a(size);
+        std::vector<bigint<n> > b(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            a[i] = (i % 5 == 0 ? -FieldT::one() : FieldT::random_element());
+            b[i].randomize();
+        }
+        /* from_bigints also takes values that are not reduced mod p */
+        if (size != 0)
+        {
+            for (mp_size_t j = 0; j < n; j++)
+            {
+                b[0].data[j] = ~mp_limb_t(0);
+            }
+        }
+
+        std::vector<bigint<n> > a_out(size);
+        std::vector<FieldT> b_out(size);
+        to_bigints(a.data(), size, a_out.data());
+        from_bigints(b.data(), size, b_out.data());
+
+        for (size_t i = 0; i < size; i++)
+        {
+            EXPECT_EQ(a_out[i], a[i].as_bigint());
+            EXPECT_EQ(b_out[i], FieldT(b[i]));
+        }
+    }
+}
+
+/* sets the Montgomery constants needed for arithmetic and inversion */
+template<typename FieldT>
+void init_small_field()
+{
+    const mp_size_t n = FieldT::num_limbs;
+    mpz_t m, r;
+    mpz_init(m);
+    mpz_init(r);
+    FieldT::mod.to_mpz(m);
+
+    mpz_setbit(r, 2 * n * GMP_NUMB_BITS);
+    mpz_mod(r, r, m);
+    FieldT::Rsquared = bigint<n>(r);
+    mpz_set_ui(r, 0);
+    mpz_setbit(r, 3 * n * GMP_NUMB_BITS);
+    mpz_mod(r, r, m);
+    FieldT::Rcubed = bigint<n>(r);
+
+    /* inv = -p^(-1) mod 2^64, by Newton iteration */
+    mp_limb_t p_inv = 1;
+    for (size_t i = 0; i < 6; i++)
+    {
+        p_inv *= 2 - FieldT::mod.data[0] * p_inv;
+    }
+    FieldT::inv = -p_inv;
+    FieldT::num_bits = FieldT::mod.num_bits();
+
+    mpz_clear(m);
+    mpz_clear(r);
+}
+
+template<typename FieldT>
+void test_small_field()
+{
+    init_small_field<FieldT>();
+
+    const mp_size_t n = FieldT::num_limbs;
+    mpz_t m, a, b, r;
+    mpz_init(m);
+    mpz_init(a);
+    mpz_init(b);
+    mpz_init(r);
+    FieldT::mod.to_mpz(m);
+
+    for (size_t i = 0; i < 1000; i++)
+    {
+        const FieldT x = (i == 0 ? -FieldT::one() : FieldT::random_element());
+        const FieldT y = (i < 2 ? -FieldT::one() : FieldT::random_element());
+        x.as_bigint().to_mpz(a);
+        y.as_bigint().to_mpz(b);
+
+        mpz_mul(r, a, b);
+        mpz_mod(r, r, m);
+        EXPECT_EQ((x * y).as_bigint(), bigint<n>(r));
+        mpz_add(r, a, b);
+        mpz_mod(r, r, m);
+        EXPECT_EQ((x + y).as_bigint(), bigint<n>(r));
+        mpz_sub(r, a, b);
+        mpz_mod(r, r, m);
+        EXPECT_EQ((x - y).as_bigint(), bigint<n>(r));
+
+        /* lazy reduction, where p * R leaves no spare bit in the wide value */
+        mpz_mul(r, a, b);
+        mpz_mod(r, r, m);
+        EXPECT_EQ(x.mul_unreduced(y).reduce().as_bigint(), bigint<n>(r));
+        mpz_mul(r, a, a);
+        mpz_mod(r, r, m);
+        EXPECT_EQ(x.squared_unreduced().reduce().as_bigint(), bigint<n>(r));
+        mpz_addmul(r, a, b);
+        mpz_mod(r, r, m);
+        EXPECT_EQ((x.squared_unreduced() + x.mul_unreduced(y)).reduce().as_bigint(), bigint<n>(r));
+        mpz_mul(r, a, a);
+        mpz_submul(r, a, b);
+        mpz_mod(r, r, m);
+        EXPECT_EQ((x.squared_unreduced() - x.mul_unreduced(y)).reduce().as_bigint(), bigint<n>(r));
+
+        EXPECT_EQ(x.squared(), x * x);
+        EXPECT_EQ(-x + x, FieldT::zero());
+        if (!x.is_zero())
+        {
+            EXPECT_EQ(x * x.inverse(), FieldT::one());
+            EXPECT_EQ(x.inverse_constant_time(), x.inverse());
+        }
+    }
+    EXPECT_EQ(-FieldT::zero(), FieldT::zero());
+
+    mpz_clear(m);
+    mpz_clear(a);
+    mpz_clear(b);
+    mpz_clear(r);
+}
+
 template<typename ppT>
 void test_all_fields()
 {
@@ -246,6 +890,41 @@ void test_Fp4_toom_cook()
     }
 }
 
+template<typename Fp12T>
+void test_Fp12_sparse_mul()
+{
+    typedef typename Fp12T::my_Fp2 Fp2T;
+    typedef typename Fp12T::my_Fp6 Fp6T;
+    /* W^2 = V, and Fp6_3over2_non_residue_c0 matches the runtime non-residue */
+    EXPECT_EQ(Fp12T::non_residue, Fp6T::non_residue);
+    for (size_t i = 0; i < 20; i++)
+    {
+        const Fp12T a = Fp12T::random_element();
+        const Fp2T x0 = Fp2T::random_element(), x1 = Fp2T::random_element(), x2 = Fp2T::random_element();
+        const Fp2T y0 = Fp2T::random_element(), y1 = Fp2T::random_element(), y2 = Fp2T::random_element();
+
+        /* the lines as dense elements, see the OLD comments of mul_by_024 and mul_by_045 */
+        const Fp12T l024(Fp6T(x0, Fp2T::zero(), x2), Fp6T(Fp2T::zero(), x1, Fp2T::zero()));
+        const Fp12T m024(Fp6T(y0, Fp2T::zero(), y2), Fp6T(Fp2T::zero(), y1, Fp2T::zero()));
+        const Fp12T l045(Fp6T(x1, Fp2T::zero(), Fp2T::zero()), Fp6T(Fp2T::zero(), x0, x2));
+        const Fp12T m045(Fp6T(y1, Fp2T::zero(), Fp2T::zero()), Fp6T(Fp2T::zero(), y0, y2));
+
+        EXPECT_EQ(a.mul_by_024(x0, x1, x2), a * l024);
+        EXPECT_EQ(a.mul_by_045(x0, x1, x2), a * l045);
+
+        const Fp12T ll024 = Fp12T::mul_024_by_024(x0, x1, x2, y0, y1, y2);
+        EXPECT_EQ(ll024, l024 * m024);
+        EXPECT_EQ(a.mul_by_01234(ll024), a * l024 * m024);
+
+        const Fp12T ll045 = Fp12T::mul_045_by_045(x0, x1, x2, y0, y1, y2);
+        EXPECT_EQ(ll045, l045 * m045);
+        EXPECT_EQ(a.mul_by_01245(ll045), a * l045 * m045);
+
+        EXPECT_EQ(a.c0.mul_by_01(y0, y1), a.c0 * Fp6T(y0, y1, Fp2T::zero()));
+        EXPECT_EQ(Fp6T::mul_by_non_residue(x0), Fp6T::non_residue * x0);
+    }
+}
+
 TEST_F(FpnFieldsTest, GeneralTest)
 {
     test_all_fields<edwards_pp>();
@@ -265,15 +944,236 @@ TEST_F(FpnFieldsTest, GeneralTest)
 #endif
 }
 
+TEST_F(FpnFieldsTest, MulxAdxTest)
+{
+    if (!cpu_supports_mulx_adx())
+    {
+        return;
+    }
+
+    test_mulx_adx<Fr<alt_bn128_pp> >();
+    test_mulx_adx<Fq<alt_bn128_pp> >();
+    test_mulx_adx<Fq<mnt4_pp> >();
+    test_mulx_adx<Fq<mnt6_pp> >();
+    test_mulx_adx<Fr<bls12_381_pp> >();
+    test_mulx_adx<Fq<bls12_381_pp> >();
+}
+
+TEST_F(FpnFieldsTest, LazyReductionTest)
+{
+    test_lazy_reduction<Fq<edwards_pp> >();
+    test_lazy_reduction<Fr<alt_bn128_pp> >();
+    test_lazy_reduction<Fq<alt_bn128_pp> >();
+    test_lazy_reduction<Fq<mnt4_pp> >();
+    test_lazy_reduction<Fq<mnt6_pp> >();
+    test_lazy_reduction<Fr<bls12_381_pp> >();
+    test_lazy_reduction<Fq<bls12_381_pp> >();
+}
+
+TEST_F(FpnFieldsTest, AdditionChainTest)
+{
+    test_addition_chain<Fq<edwards_pp> >();
+    test_addition_chain<Fr<mnt4_pp> >();
+    test_addition_chain<Fq<mnt4_pp> >();
+    test_addition_chain<Fr<alt_bn128_pp> >();
+    test_addition_chain<Fq<alt_bn128_pp> >();
+    test_addition_chain<Fr<bls12_381_pp> >();
+    test_addition_chain<Fq<bls12_381_pp> >();
+}
+
+TEST_F(FpnFieldsTest, PowerTest)
+{
+    test_power<Fq<edwards_pp> >();
+    test_power<Fq<mnt4_pp> >();
+    test_power<Fq<alt_bn128_pp> >();
+    test_power<Fqe<alt_bn128_pp> >();
+    test_power<Fqk<alt_bn128_pp> >();
+    test_power<Fqk<mnt6_pp> >();
+
+    test_cyclotomic_power<mnt4_pp>();
+    test_cyclotomic_power<mnt6_pp>();
+    test_cyclotomic_power<alt_bn128_pp>();
+    test_cyclotomic_power<bls12_381_pp>();
+}
+
+TEST_F(FpnFieldsTest, FieldMultiExpTest)
+{
+    test_field_multi_exp<Fq<alt_bn128_pp>, Fr<alt_bn128_pp> >(0, 1);
+    test_field_multi_exp<Fq<alt_bn128_pp>, Fr<alt_bn128_pp> >(1, 1);
+    test_field_multi_exp<Fq<alt_bn128_pp>, Fr<alt_bn128_pp> >(10, 1);
+    test_field_multi_exp<Fq<alt_bn128_pp>, Fr<alt_bn128_pp> >(10, 3);
+    /* enough bases for the bucket method */
+    test_field_multi_exp<Fq<alt_bn128_pp>, Fr<alt_bn128_pp> >(1000, 1);
+    test_field_multi_exp<Fq<mnt4_pp>, Fr<mnt4_pp> >(10, 1);
+    test_field_multi_exp<Fqk<alt_bn128_pp>, Fr<alt_bn128_pp> >(3, 1);
+
+    test_cyclotomic_multi_exp<alt_bn128_pp>(4);
+    test_cyclotomic_multi_exp<bls12_381_pp>(3);
+    test_cyclotomic_multi_exp<mnt4_pp>(3);
+    test_cyclotomic_multi_exp<mnt6_pp>(3);
+}
+
+TEST_F(FpnFieldsTest, InnerProductTest)
+{
+    test_inner_product<Fr<alt_bn128_pp> >();
+    test_inner_product<Fq<mnt4_pp> >();
+    test_inner_product<Fq<bls12_381_pp> >();
+    test_inner_product<Fqe<alt_bn128_pp> >();
+}
+
+TEST_F(FpnFieldsTest, SqrtTableTest)
+{
+    test_sqrt_table<Fr<edwards_pp> >();
+    test_sqrt_table<Fr<mnt4_pp> >();
+    test_sqrt_table<Fr<mnt6_pp> >();
+    test_sqrt_table<Fr<alt_bn128_pp> >();
+    test_sqrt_table<Fr<bls12_381_pp> >();
+#ifdef CURVE_BN128
+    test_sqrt_table<Fr<bn128_pp> >();
+#endif
+}
+
+TEST_F(FpnFieldsTest, LegendreTest)
+{
+    test_legendre<Fr<edwards_pp> >();
+    test_legendre<Fq<edwards_pp> >();
+    test_legendre<Fr<mnt4_pp> >();
+    test_legendre<Fq<mnt4_pp> >();
+    test_legendre<Fr<alt_bn128_pp> >();
+    test_legendre<Fq<alt_bn128_pp> >();
+    test_legendre<Fr<bls12_381_pp> >();
+    test_legendre<Fq<bls12_381_pp> >();
+}
+
+#if GMP_NUMB_BITS == 64
+TEST_F(FpnFieldsTest, ConstexprParamsTest)
+{
+    test_constexpr_params<Fr<alt_bn128_pp>, Fp_params<alt_bn128_r_limbs, alt_bn128_modulus_r> >();
+    test_constexpr_params<Fq<alt_bn128_pp>, Fp_params<alt_bn128_q_limbs, alt_bn128_modulus_q> >();
+    test_constexpr_params<Fr<bls12_381_pp>, Fp_params<bls12_381_r_limbs, bls12_381_modulus_r> >();
+    test_constexpr_params<Fq<bls12_381_pp>, Fp_params<bls12_381_q_limbs, bls12_381_modulus_q> >();
+    EXPECT_FALSE((Fp_params<mnt4_q_limbs, mnt46_modulus_B>::is_constexpr));
+}
+#endif
+
+TEST_F(FpnFieldsTest, RandomVectorTest)
+{
+    typedef Fr<bls12_381_pp> FieldT;
+    thread_rng().seed(42);
+    const std::vector<FieldT> v1 = random_vector<FieldT>(100);
+    thread_rng().seed(42);
+    const std::vector<FieldT> v2 = random_vector<FieldT>(100);
+    const std::vector<FieldT> v3 = random_vector<FieldT>(100);
+    thread_rng().reseed();
+
+    EXPECT_EQ(v1.size(), 100u);
+    EXPECT_EQ(v1, v2);
+    EXPECT_NE(v1, v3);
+    for (size_t i = 0; i < v1.size(); i++)
+    {
+        EXPECT_LT(mpn_cmp(v1[i].mont_repr.data, FieldT::mod.data, FieldT::num_limbs), 0);
+    }
+}
+
+TEST_F(FpnFieldsTest, RedundantRepresentationTest)
+{
+    test_redundant_representation<Fq<mnt4_pp> >();
+    test_redundant_representation<Fr<alt_bn128_pp> >();
+    test_redundant_representation<Fq<alt_bn128_pp> >();
+    test_redundant_representation<Fr<bls12_381_pp> >();
+    test_redundant_representation<Fq<bls12_381_pp> >();
+#if defined(REDUNDANT_FP) && GMP_NUMB_BITS == 64
+    EXPECT_TRUE(Fr<alt_bn128_pp>::is_redundant);
+    EXPECT_TRUE(Fq<alt_bn128_pp>::is_redundant);
+    EXPECT_TRUE(Fq<bls12_381_pp>::is_redundant);
+#endif
+    /* 4r > 2^256, so BLS12-381 Fr never uses the redundant form */
+    EXPECT_FALSE(Fr<bls12_381_pp>::is_redundant);
+}
+
+#if GMP_NUMB_BITS == 64
+TEST_F(FpnFieldsTest, SmallFieldsTest)
+{
+    test_small_field<Fp_model<1, goldilocks_modulus> >();
+    test_small_field<Fp_model<2, modulus_2_128_minus_159> >();
+
+    /* neither modulus has a spare top bit, so reduce() must keep the final carry */
+    test_lazy_reduction<Fp_model<1, goldilocks_modulus> >();
+    test_lazy_reduction<Fp_model<2, modulus_2_128_minus_159> >();
+    test_inner_product<Fp_model<1, goldilocks_modulus> >();
+    test_inner_product<Fp_model<2, modulus_2_128_minus_159> >();
+}
+#endif
+
+TEST_F(FpnFieldsTest, SHA512RngBatchTest)
+{
+    test_SHA512_rng_batch<Fr<edwards_pp> >();
+    test_SHA512_rng_batch<Fr<alt_bn128_pp> >();
+    test_SHA512_rng_batch<Fq<bls12_381_pp> >();
+}
+
+TEST_F(FpnFieldsTest, InverseTest)
+{
+    test_inverse<Fr<edwards_pp> >();
+    test_inverse<Fq<edwards_pp> >();
+    test_inverse<Fr<mnt4_pp> >();
+    test_inverse<Fq<mnt4_pp> >();
+    test_inverse<Fr<alt_bn128_pp> >();
+    test_inverse<Fq<alt_bn128_pp> >();
+    test_inverse<Fr<bls12_381_pp> >();
+    test_inverse<Fq<bls12_381_pp> >();
+
+    test_batch_invert<Fq<alt_bn128_pp> >();
+    test_batch_invert<Fq<mnt4_pp> >();
+    test_batch_invert<Fqe<bls12_381_pp> >();
+}
+
+TEST_F(FpnFieldsTest, BatchArithmeticTest)
+{
+    test_batch_arithmetic<Fq<edwards_pp> >();
+    test_batch_arithmetic<Fr<alt_bn128_pp> >();
+    test_batch_arithmetic<Fq<alt_bn128_pp> >();
+    test_batch_arithmetic<Fq<mnt4_pp> >();
+    test_batch_arithmetic<Fr<bls12_381_pp> >();
+    test_batch_arithmetic<Fq<bls12_381_pp> >();
+    test_batch_arithmetic<Fqe<alt_bn128_pp> >();
+
+    test_bigint_conversion<Fq<edwards_pp> >();
+    test_bigint_conversion<Fr<alt_bn128_pp> >();
+    test_bigint_conversion<Fq<mnt4_pp> >();
+    test_bigint_conversion<Fq<bls12_381_pp> >();
+}
+
 TEST_F(FpnFieldsTest, SquareTest)
 {
     test_cyclotomic_squaring<Fqk<edwards_pp> >();
 
     test_two_squarings<Fqe<mnt4_pp> >();
+    test_two_squarings<Fqe<alt_bn128_pp> >();
+    test_two_squarings<Fqe<bls12_381_pp> >();
+    test_two_squarings<Fqk<alt_bn128_pp> >();
+    test_two_squarings<Fqk<bls12_381_pp> >();
+
+    test_Fp2_non_residue<Fqe<alt_bn128_pp> >();
+    test_Fp2_non_residue<Fqe<bls12_381_pp> >();
+    test_Fp2_non_residue<Fqe<mnt4_pp> >();
+
+    test_Fp3_mul<Fqe<mnt6_pp> >();
+    test_Fp3_mul<Fqe<edwards_pp> >();
+
     test_cyclotomic_squaring<Fqk<mnt4_pp> >();
+
+    test_cyclotomic_squaring_compressed<alt_bn128_pp>();
+    test_cyclotomic_squaring_compressed<bls12_381_pp>();
 }
 
 TEST_F(FpnFieldsTest, ToomCookTest)
 {
     test_Fp4_toom_cook<mnt4_Fq4>();
 }
+
+TEST_F(FpnFieldsTest, SparseMulTest)
+{
+    test_Fp12_sparse_mul<Fqk<alt_bn128_pp> >();
+    test_Fp12_sparse_mul<Fqk<bls12_381_pp> >();
+}
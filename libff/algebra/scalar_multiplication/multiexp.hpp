@@ -72,8 +72,42 @@ T multi_exp_with_mixed_addition(typename std::vector<T>::const_iterator vec_star
                                 const std::size_t chunks);
 
 /**
- * A convenience function for calculating a pure inner product, where the
- * more complicated methods are not required.
+ * Computes the product
+ * \prod_i base_start[i]^exponent_start[i]
+ * of elements of a field T (e.g. Fp_model), exponentiated by the elements
+ * of FieldT as in multi_exp. All powers share one chain of squarings: for
+ * few bases the exponents are cut into sliding windows over a table of odd
+ * powers per base (Straus), for many they are cut into fixed windows whose
+ * bases are collected in buckets (as in multi_exp_method_BDLO12). The
+ * cheaper of the two is picked from the number of bases and exponent bits.
+ * Input is split into the given number of chunks, and, when compiled with
+ * MULTICORE, the chunks are processed in parallel.
+ */
+template<typename T, typename FieldT>
+T field_multi_exp(typename std::vector<T>::const_iterator base_start,
+                  typename std::vector<T>::const_iterator base_end,
+                  typename std::vector<FieldT>::const_iterator exponent_start,
+                  typename std::vector<FieldT>::const_iterator exponent_end,
+                  const std::size_t chunks);
+
+/**
+ * As field_multi_exp, for bases in the cyclotomic subgroup of T (i.e. GT in
+ * Fp4, Fp6_2over3 or Fp12_2over3over2). Squarings are cyclotomic_squared()
+ * and, since unitary_inverse() is free, the Straus exponents are recoded in
+ * wNAF as in multi_exp_method_naive.
+ */
+template<typename T, typename FieldT>
+T cyclotomic_multi_exp(typename std::vector<T>::const_iterator base_start,
+                       typename std::vector<T>::const_iterator base_end,
+                       typename std::vector<FieldT>::const_iterator exponent_start,
+                       typename std::vector<FieldT>::const_iterator exponent_end,
+                       const std::size_t chunks);
+
+/**
+ * Computes the inner product \sum_i a_start[i] * b_start[i] of two vectors
+ * of field elements. For Fp_model the products are accumulated unreduced
+ * (see Fp_wide_model) and reduced once per block of the input; when
+ * compiled with MULTICORE, the blocks are processed in parallel.
  */
 template <typename T>
 T inner_product(typename std::vector<T>::const_iterator a_start,
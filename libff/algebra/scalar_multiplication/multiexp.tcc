@@ -15,6 +15,7 @@
 #include <cassert>
 #include <type_traits>
 
+#include <libff/algebra/field_utils/algorithms.hpp>
 #include <libff/algebra/field_utils/bigint.hpp>
 #include <libff/algebra/scalar_multiplication/multiexp.hpp>
 #include <libff/algebra/scalar_multiplication/wnaf.hpp>
@@ -97,7 +98,7 @@ public:
         else
 #endif
         {
-            return (mpn_cmp(this->r.data, other.r.data, n) < 0);
+            return (limbs_cmp<n>(this->r.data, other.r.data) < 0);
         }
     }
 };
@@ -178,11 +179,14 @@ T multi_exp_inner(
     const mp_size_t exp_num_limbs =
         std::remove_reference<decltype(*exponents)>::type::num_limbs;
     std::vector<bigint<exp_num_limbs> > bn_exponents(length);
-    size_t num_bits = 0;
+    if (length != 0)
+    {
+        to_bigints(&*exponents, length, bn_exponents.data());
+    }
 
+    size_t num_bits = 0;
     for (size_t i = 0; i < length; i++)
     {
-        bn_exponents[i] = exponents[i].as_bigint();
         num_bits = std::max(num_bits, bn_exponents[i].num_bits());
     }
 
@@ -363,7 +367,7 @@ T multi_exp_inner(
         else
         {
             // x A + y B => (x-y) A + y (B+A)
-            mpn_sub_n(a.r.data, a.r.data, b.r.data, n);
+            limbs_sub<n>(a.r.data, a.r.data, b.r.data);
             g[b.idx] = g[b.idx] + g[a.idx];
         }
 
@@ -501,15 +505,341 @@ T multi_exp_with_mixed_addition(typename std::vector<T>::const_iterator vec_star
     return acc + multi_exp<T, FieldT, Method>(g.begin(), g.end(), p.begin(), p.end(), chunks);
 }
 
+/* squaring and, where it is cheap, inversion in T, for field_multi_exp */
+template<typename T>
+struct field_exp_ops {
+    static const bool cheap_inverse = false;
+    static T squared(const T &x) { return x.squared(); }
+    static T inverse(const T &x) { return x.inverse(); }
+};
+
+/* the same in the cyclotomic subgroup of T, for cyclotomic_multi_exp */
+template<typename T>
+struct cyclotomic_exp_ops {
+    static const bool cheap_inverse = true;
+    static T squared(const T &x) { return x.cyclotomic_squared(); }
+    static T inverse(const T &x) { return x.unitary_inverse(); }
+};
+
+/* Straus: one table of odd powers per base, interleaved over one chain of squarings */
+template<typename T, typename Ops, mp_size_t n>
+T straus_field_multi_exp(const std::vector<T> &bases,
+                         const std::vector<bigint<n> > &exponents,
+                         const size_t w)
+{
+    const size_t length = bases.size();
+    const size_t table_size = 1ul << (w-1);
+
+    std::vector<std::vector<long> > digits(length);
+    std::vector<T> table(length * table_size);
+    std::vector<T> inverse_table(Ops::cheap_inverse ? length * table_size : 0);
+    size_t num_digits = 0;
+    for (size_t i = 0; i < length; ++i)
+    {
+        digits[i] = (Ops::cheap_inverse ? find_wnaf(w, exponents[i]) : find_sliding_window(w, exponents[i]));
+        num_digits = std::max(num_digits, digits[i].size());
+
+        /* table[i * table_size + k] = bases[i]^(2k+1) */
+        table[i * table_size] = bases[i];
+        if (table_size > 1)
+        {
+            const T base_squared = Ops::squared(bases[i]);
+            for (size_t k = 1; k < table_size; ++k)
+            {
+                table[i * table_size + k] = table[i * table_size + k - 1] * base_squared;
+            }
+        }
+        if (Ops::cheap_inverse)
+        {
+            for (size_t k = 0; k < table_size; ++k)
+            {
+                inverse_table[i * table_size + k] = Ops::inverse(table[i * table_size + k]);
+            }
+        }
+    }
+
+    T result = T::one();
+    bool result_nonzero = false;
+    for (long b = static_cast<long>(num_digits) - 1; b >= 0; --b)
+    {
+        if (result_nonzero)
+        {
+            result = Ops::squared(result);
+        }
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            const long d = (static_cast<size_t>(b) < digits[i].size() ? digits[i][b] : 0);
+            if (d == 0)
+            {
+                continue;
+            }
+
+            const T &factor = (d > 0 ? table[i * table_size + d/2] : inverse_table[i * table_size + (-d)/2]);
+            result = (result_nonzero ? result * factor : factor);
+            result_nonzero = true;
+        }
+    }
+
+    return result;
+}
+
+/* the bucket method of multi_exp_method_BDLO12, in multiplicative notation */
+template<typename T, typename Ops, mp_size_t n>
+T bucket_field_multi_exp(const std::vector<T> &bases,
+                         const std::vector<bigint<n> > &exponents,
+                         const size_t num_bits,
+                         const size_t c)
+{
+    const size_t length = bases.size();
+    const size_t num_groups = (num_bits + c - 1) / c;
+
+    T result = T::one();
+    bool result_nonzero = false;
+
+    std::vector<T> buckets(1ul << c);
+    std::vector<bool> bucket_nonzero(1ul << c);
+    for (size_t k = num_groups - 1; k <= num_groups; k--)
+    {
+        if (result_nonzero)
+        {
+            for (size_t i = 0; i < c; i++)
+            {
+                result = Ops::squared(result);
+            }
+        }
+
+        std::fill(bucket_nonzero.begin(), bucket_nonzero.end(), false);
+        for (size_t i = 0; i < length; i++)
+        {
+            size_t id = 0;
+            for (size_t j = 0; j < c; j++)
+            {
+                if (exponents[i].test_bit(k*c + j))
+                {
+                    id |= 1ul << j;
+                }
+            }
+
+            if (id == 0)
+            {
+                continue;
+            }
+
+            buckets[id] = (bucket_nonzero[id] ? buckets[id] * bases[i] : bases[i]);
+            bucket_nonzero[id] = true;
+        }
+
+        /* \prod_id buckets[id]^id, as a product of running products */
+        T running_product;
+        bool running_product_nonzero = false;
+        for (size_t i = (1ul << c) - 1; i > 0; i--)
+        {
+            if (bucket_nonzero[i])
+            {
+                running_product = (running_product_nonzero ? running_product * buckets[i] : buckets[i]);
+                running_product_nonzero = true;
+            }
+
+            if (running_product_nonzero)
+            {
+                result = (result_nonzero ? result * running_product : running_product);
+                result_nonzero = true;
+            }
+        }
+    }
+
+    return result;
+}
+
+template<typename T, typename FieldT, typename Ops>
+T field_multi_exp_inner(typename std::vector<T>::const_iterator base_start,
+                        typename std::vector<T>::const_iterator base_end,
+                        typename std::vector<FieldT>::const_iterator exponent_start,
+                        typename std::vector<FieldT>::const_iterator exponent_end)
+{
+    const mp_size_t n = FieldT::num_limbs;
+    std::vector<T> bases;
+    std::vector<bigint<n> > exponents;
+    size_t num_bits = 0;
+
+    typename std::vector<T>::const_iterator base_it;
+    typename std::vector<FieldT>::const_iterator exponent_it;
+    for (base_it = base_start, exponent_it = exponent_start; base_it != base_end; ++base_it, ++exponent_it)
+    {
+        const bigint<n> e = exponent_it->as_bigint();
+        if (!e.is_zero())
+        {
+            bases.emplace_back(*base_it);
+            exponents.emplace_back(e);
+            num_bits = std::max(num_bits, e.num_bits());
+        }
+    }
+    assert(exponent_it == exponent_end);
+    UNUSED(exponent_end);
+
+    if (bases.empty())
+    {
+        return T::one();
+    }
+
+    /*
+      Multiplications besides the num_bits squarings: with Straus, a table
+      of 2^(w-1) odd powers and about num_bits/(w+1) windows per base; with
+      buckets, per group of c bits one per base and two per bucket.
+     */
+    const size_t length = bases.size();
+    const size_t best_w = sliding_window_size(num_bits);
+    const size_t best_straus_cost = length * sliding_window_cost(num_bits, best_w);
+
+    size_t best_c = 1;
+    size_t best_bucket_cost = num_bits * (length + 4);
+    for (size_t c = 2; c <= 16; ++c)
+    {
+        const size_t cost = (num_bits + c - 1) / c * (length + (2ul << c));
+        if (cost < best_bucket_cost)
+        {
+            best_bucket_cost = cost;
+            best_c = c;
+        }
+    }
+
+    if (best_straus_cost <= best_bucket_cost)
+    {
+        return straus_field_multi_exp<T, Ops, n>(bases, exponents, best_w);
+    }
+    return bucket_field_multi_exp<T, Ops, n>(bases, exponents, num_bits, best_c);
+}
+
+template<typename T, typename FieldT, typename Ops>
+T field_multi_exp_chunked(typename std::vector<T>::const_iterator base_start,
+                          typename std::vector<T>::const_iterator base_end,
+                          typename std::vector<FieldT>::const_iterator exponent_start,
+                          typename std::vector<FieldT>::const_iterator exponent_end,
+                          const size_t chunks)
+{
+    const size_t total = base_end - base_start;
+    if ((total < chunks) || (chunks == 1))
+    {
+        return field_multi_exp_inner<T, FieldT, Ops>(base_start, base_end, exponent_start, exponent_end);
+    }
+
+    const size_t one = total/chunks;
+
+    std::vector<T> partial(chunks, T::one());
+
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < chunks; ++i)
+    {
+        partial[i] = field_multi_exp_inner<T, FieldT, Ops>(
+             base_start + i*one,
+             (i == chunks-1 ? base_end : base_start + (i+1)*one),
+             exponent_start + i*one,
+             (i == chunks-1 ? exponent_end : exponent_start + (i+1)*one));
+    }
+
+    T final = T::one();
+
+    for (size_t i = 0; i < chunks; ++i)
+    {
+        final = final * partial[i];
+    }
+
+    return final;
+}
+
+template<typename T, typename FieldT>
+T field_multi_exp(typename std::vector<T>::const_iterator base_start,
+                  typename std::vector<T>::const_iterator base_end,
+                  typename std::vector<FieldT>::const_iterator exponent_start,
+                  typename std::vector<FieldT>::const_iterator exponent_end,
+                  const size_t chunks)
+{
+    return field_multi_exp_chunked<T, FieldT, field_exp_ops<T> >(
+        base_start, base_end, exponent_start, exponent_end, chunks);
+}
+
+template<typename T, typename FieldT>
+T cyclotomic_multi_exp(typename std::vector<T>::const_iterator base_start,
+                       typename std::vector<T>::const_iterator base_end,
+                       typename std::vector<FieldT>::const_iterator exponent_start,
+                       typename std::vector<FieldT>::const_iterator exponent_end,
+                       const size_t chunks)
+{
+    return field_multi_exp_chunked<T, FieldT, cyclotomic_exp_ops<T> >(
+        base_start, base_end, exponent_start, exponent_end, chunks);
+}
+
+/*
+  The dot product of length elements. For types with mul_unreduced (i.e.
+  Fp_model) the products are summed at double width, with a single
+  Montgomery reduction at the end.
+ */
+template<typename T>
+auto inner_product_block(typename std::vector<T>::const_iterator a,
+                         typename std::vector<T>::const_iterator b,
+                         const size_t length, int) -> decltype(a->mul_unreduced(*b).reduce())
+{
+    auto acc = a->mul_unreduced(*b);
+    for (size_t i = 1; i < length; ++i)
+    {
+        acc += a[i].mul_unreduced(b[i]);
+    }
+    return acc.reduce();
+}
+
+template<typename T>
+T inner_product_block(typename std::vector<T>::const_iterator a,
+                      typename std::vector<T>::const_iterator b,
+                      const size_t length, long)
+{
+    T acc = (*a) * (*b);
+    for (size_t i = 1; i < length; ++i)
+    {
+        acc = acc + a[i] * b[i];
+    }
+    return acc;
+}
+
 template <typename T>
 T inner_product(typename std::vector<T>::const_iterator a_start,
                 typename std::vector<T>::const_iterator a_end,
                 typename std::vector<T>::const_iterator b_start,
                 typename std::vector<T>::const_iterator b_end)
 {
-    return multi_exp<T, T, multi_exp_method_naive_plain>(
-        a_start, a_end,
-        b_start, b_end, 1);
+#ifndef NDEBUG
+    assert(std::distance(a_start, a_end) == std::distance(b_start, b_end));
+#else
+    libff::UNUSED(b_end);
+#endif
+    const size_t length = a_end - a_start;
+    if (length == 0)
+    {
+        return T::zero();
+    }
+
+    /* fixed-size blocks, so that the result does not depend on the number of threads */
+    const size_t block_size = 4096;
+    const size_t num_blocks = (length + block_size - 1) / block_size;
+    std::vector<T> partial(num_blocks);
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t i = 0; i < num_blocks; ++i)
+    {
+        const size_t begin = i * block_size;
+        partial[i] = inner_product_block<T>(a_start + begin, b_start + begin,
+                                            std::min(length, begin + block_size) - begin, 0);
+    }
+
+    T result = partial[0];
+    for (size_t i = 1; i < num_blocks; ++i)
+    {
+        result = result + partial[i];
+    }
+    return result;
 }
 
 template<typename T>
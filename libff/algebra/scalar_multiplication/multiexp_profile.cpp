@@ -48,14 +48,12 @@ test_instances_t<GroupT> generate_group_elements(size_t count, size_t size)
 template<typename FieldT>
 test_instances_t<FieldT> generate_scalars(size_t count, size_t size)
 {
-    // we use SHA512_rng because it is much faster than
+    // we use SHA512_rng_batch because it is much faster than
     // FieldT::random_element()
     test_instances_t<FieldT> result(count);
 
     for (size_t i = 0; i < count; i++) {
-        for (size_t j = 0; j < size; j++) {
-            result[i].push_back(SHA512_rng<FieldT>(i * size + j));
-        }
+        result[i] = SHA512_rng_batch<FieldT>(i * size, size);
     }
 
     return result;
@@ -37,11 +37,11 @@ std::vector<long> find_wnaf(const size_t window_size, const bigint<n> &scalar)
 
             if (u > 0)
             {
-                mpn_sub_1(c.data, c.data, n, u);
+                limbs_sub_1<n>(c.data, c.data, u);
             }
             else
             {
-                mpn_add_1(c.data, c.data, n, -u);
+                limbs_add_1<n>(c.data, c.data, -u);
             }
         }
         else
@@ -51,7 +51,7 @@ std::vector<long> find_wnaf(const size_t window_size, const bigint<n> &scalar)
         res[j] = u;
         ++j;
 
-        mpn_rshift(c.data, c.data, n, 1); // c = c/2
+        limbs_rshift<n>(c.data, c.data, 1); // c = c/2
     }
 
     return res;
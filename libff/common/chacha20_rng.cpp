@@ -0,0 +1,170 @@
+/** @file
+ *****************************************************************************
+ Implementation of a fast, seedable pseudorandom generator based on ChaCha20.
+
+ See chacha20_rng.hpp .
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+
+#include <pthread.h>
+
+#include <libff/common/chacha20_rng.hpp>
+
+namespace libff {
+
+using std::size_t;
+
+#define CHACHA20_ROTL(x, k) (((x) << (k)) | ((x) >> (32 - (k))))
+
+#define CHACHA20_QUARTERROUND(a, b, c, d)              \
+    a += b; d ^= a; d = CHACHA20_ROTL(d, 16);           \
+    c += d; b ^= c; b = CHACHA20_ROTL(b, 12);           \
+    a += b; d ^= a; d = CHACHA20_ROTL(d, 8);            \
+    c += d; b ^= c; b = CHACHA20_ROTL(b, 7);
+
+/* one 64-byte ChaCha20 block for the given key and block counter */
+static void chacha20_block(uint32_t out[16], const uint32_t key[8], const uint64_t counter)
+{
+    uint32_t x[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574, // "expand 32-byte k"
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        (uint32_t)counter, (uint32_t)(counter >> 32), 0, 0 };
+    uint32_t in[16];
+    std::memcpy(in, x, sizeof(in));
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        CHACHA20_QUARTERROUND(x[0], x[4], x[8], x[12])
+        CHACHA20_QUARTERROUND(x[1], x[5], x[9], x[13])
+        CHACHA20_QUARTERROUND(x[2], x[6], x[10], x[14])
+        CHACHA20_QUARTERROUND(x[3], x[7], x[11], x[15])
+        CHACHA20_QUARTERROUND(x[0], x[5], x[10], x[15])
+        CHACHA20_QUARTERROUND(x[1], x[6], x[11], x[12])
+        CHACHA20_QUARTERROUND(x[2], x[7], x[8], x[13])
+        CHACHA20_QUARTERROUND(x[3], x[4], x[9], x[14])
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        out[i] = x[i] + in[i];
+    }
+}
+
+/*
+  Bumped in the child after each fork(). A generator keyed from
+  std::random_device remembers the value at keying time, and reseeds when
+  it has changed, so that a forked child does not repeat its parent's
+  stream. Reading an atomic is much cheaper than calling getpid() on every
+  fill().
+ */
+static std::atomic<uint64_t> fork_generation(1);
+
+static void on_fork_child()
+{
+    fork_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+chacha20_rng::chacha20_rng()
+{
+    reseed();
+}
+
+chacha20_rng::chacha20_rng(const uint64_t seed_value)
+{
+    seed(seed_value);
+}
+
+void chacha20_rng::set_key(const unsigned char new_key[key_bytes])
+{
+    /* the key words are little-endian, as in RFC 8439 */
+    for (size_t i = 0; i < 8; ++i)
+    {
+        key[i] = (uint32_t)new_key[4*i] | ((uint32_t)new_key[4*i+1] << 8) |
+                 ((uint32_t)new_key[4*i+2] << 16) | ((uint32_t)new_key[4*i+3] << 24);
+    }
+    counter = 0;
+    buffer_pos = sizeof(buffer);
+    /* an explicit key is kept across fork() */
+    key_generation = 0;
+}
+
+void chacha20_rng::seed(const uint64_t seed_value)
+{
+    unsigned char k[key_bytes] = {0};
+    for (size_t i = 0; i < 8; ++i)
+    {
+        k[i] = (unsigned char)(seed_value >> (8 * i));
+    }
+    set_key(k);
+}
+
+void chacha20_rng::reseed()
+{
+    static const bool registered = (pthread_atfork(nullptr, nullptr, on_fork_child) == 0);
+    (void)registered;
+
+    std::random_device rd;
+    unsigned char k[key_bytes];
+    for (size_t i = 0; i < key_bytes; i += 4)
+    {
+        const uint32_t word = rd();
+        std::memcpy(k + i, &word, 4);
+    }
+    set_key(k);
+    key_generation = fork_generation.load(std::memory_order_relaxed);
+}
+
+void chacha20_rng::refill()
+{
+    for (size_t i = 0; i < buffered_blocks; ++i)
+    {
+        chacha20_block(buffer + i * block_words, key, counter++);
+    }
+    buffer_pos = 0;
+}
+
+void chacha20_rng::fill(void *buf, size_t num_bytes)
+{
+    if (key_generation != 0 && key_generation != fork_generation.load(std::memory_order_relaxed))
+    {
+        reseed();
+    }
+
+    unsigned char *out = static_cast<unsigned char*>(buf);
+    while (num_bytes > 0)
+    {
+        if (buffer_pos == sizeof(buffer))
+        {
+            refill();
+        }
+        const size_t chunk = std::min(num_bytes, sizeof(buffer) - buffer_pos);
+        std::memcpy(out, reinterpret_cast<const unsigned char*>(buffer) + buffer_pos, chunk);
+        /* do not leave used output around */
+        std::memset(reinterpret_cast<unsigned char*>(buffer) + buffer_pos, 0, chunk);
+        buffer_pos += chunk;
+        out += chunk;
+        num_bytes -= chunk;
+    }
+}
+
+uint64_t chacha20_rng::next_word()
+{
+    uint64_t result;
+    fill(&result, sizeof(result));
+    return result;
+}
+
+chacha20_rng &thread_rng()
+{
+    static thread_local chacha20_rng rng;
+    return rng;
+}
+
+} // namespace libff
@@ -0,0 +1,68 @@
+/** @file
+ *****************************************************************************
+ Declaration of a fast, seedable pseudorandom generator based on ChaCha20.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+#ifndef CHACHA20_RNG_HPP_
+#define CHACHA20_RNG_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libff {
+
+/**
+ * Cryptographically secure pseudorandom generator: the ChaCha20 stream
+ * cipher (RFC 8439, with a 64-bit block counter and zero nonce) keyed with
+ * a 256-bit key.
+ *
+ * By default the key is drawn from std::random_device at construction,
+ * and drawn again after a fork(), so that parent and child do not produce
+ * the same stream. set_key() and seed() make the stream reproducible, e.g.
+ * for tests or benchmarks, also across fork(); seed() only has 64 bits of
+ * entropy and is not meant for secrets.
+ */
+class chacha20_rng {
+public:
+    static const std::size_t key_bytes = 32;
+
+    chacha20_rng();
+    explicit chacha20_rng(const uint64_t seed_value);
+
+    /** Restarts the stream from the given 32-byte key. */
+    void set_key(const unsigned char new_key[key_bytes]);
+    /** Restarts the stream from a key whose first 8 bytes are seed_value (little-endian). */
+    void seed(const uint64_t seed_value);
+    /** Restarts the stream from a fresh key drawn from std::random_device. */
+    void reseed();
+
+    void fill(void *buf, std::size_t num_bytes);
+    uint64_t next_word();
+
+private:
+    static const std::size_t block_words = 16;
+    static const std::size_t buffered_blocks = 4;
+
+    uint32_t key[8];
+    uint64_t counter;
+    uint32_t buffer[buffered_blocks * block_words];
+    std::size_t buffer_pos; // in bytes
+    uint64_t key_generation; // fork generation of a random_device key, 0 for an explicit key
+
+    void refill();
+};
+
+/**
+ * The calling thread's generator, which bigint::randomize() (and so every
+ * random_element()) draws from. Each thread seeds its own from
+ * std::random_device on first use; call thread_rng().seed(...) for a
+ * reproducible stream.
+ */
+chacha20_rng &thread_rng();
+
+} // namespace libff
+
+#endif // CHACHA20_RNG_HPP_
@@ -9,13 +9,23 @@
 #ifndef RNG_HPP_
 #define RNG_HPP_
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace libff {
 
 template<typename FieldT>
 FieldT SHA512_rng(const uint64_t idx);
 
+/**
+ * Returns SHA512_rng<FieldT>(start + i) for i = 0 .. count-1. The hashes are
+ * computed several at a time by sha512_index_digests, and (if compiled with
+ * MULTICORE) the range is split across threads.
+ */
+template<typename FieldT>
+std::vector<FieldT> SHA512_rng_batch(const uint64_t start, const std::size_t count);
+
 } // namespace libff
 
 #include <libff/common/rng.tcc>
@@ -11,64 +11,131 @@
 #ifndef RNG_TCC_
 #define RNG_TCC_
 
+#include <algorithm>
 #include <gmp.h>
-#include <openssl/sha.h>
 
 #include <libff/algebra/field_utils/bigint.hpp>
 #include <libff/common/rng.hpp>
+#include <libff/common/sha512_multi.hpp>
 #include <libff/common/utils.hpp>
 
 namespace libff {
 
 using std::size_t;
 
+/*
+  Copies the first limbs of a digest into rval and clears all bits higher
+  than the MSB of the modulus. Returns false if the result is still >= the
+  modulus, i.e. must be rejected.
+ */
+template<typename FieldT>
+bool SHA512_rng_candidate(bigint<FieldT::num_limbs> &rval, const mp_limb_t *hash)
+{
+    for (mp_size_t i = 0; i < FieldT::num_limbs; ++i)
+    {
+        rval.data[i] = hash[i];
+    }
+
+    /* clear all bits higher than MSB of modulus */
+    size_t bitno = GMP_NUMB_BITS * FieldT::num_limbs - 1;
+
+    /* mod is non-zero so the loop will always terminate */
+    while (FieldT::mod.test_bit(bitno) == false)
+    {
+        const std::size_t part = bitno/GMP_NUMB_BITS;
+        const std::size_t bit = bitno - (GMP_NUMB_BITS*part);
+
+        static const mp_limb_t one = 1;
+        rval.data[part] &= ~(one<<bit);
+
+        bitno--;
+    }
+
+    return limbs_cmp<FieldT::num_limbs>(rval.data, FieldT::mod.data) < 0;
+}
+
 template<typename FieldT>
 FieldT SHA512_rng(const uint64_t idx)
 {
     assert(GMP_NUMB_BITS == 64); // current Python code cannot handle larger values, so testing here for some assumptions.
     assert(is_little_endian());
 
-    assert(FieldT::ceil_size_in_bits() <= SHA512_DIGEST_LENGTH * 8);
+    assert(FieldT::ceil_size_in_bits() <= 512);
 
     bigint<FieldT::num_limbs> rval;
+    uint64_t hash[8];
     uint64_t iter = 0;
     do
     {
-        mp_limb_t hash[((SHA512_DIGEST_LENGTH*8) + GMP_NUMB_BITS - 1)/GMP_NUMB_BITS];
+        sha512_index_digests(hash, &idx, &iter, 1);
 
-        SHA512_CTX sha512;
-        SHA512_Init(&sha512);
-        SHA512_Update(&sha512, &idx, sizeof(idx));
-        SHA512_Update(&sha512, &iter, sizeof(iter));
-        SHA512_Final((unsigned char*)hash, &sha512);
+        ++iter;
+    }
 
-        for (mp_size_t i = 0; i < FieldT::num_limbs; ++i)
-        {
-            rval.data[i] = hash[i];
-        }
+    /* if r.data is still >= modulus -- repeat (rejection sampling) */
+    while (!SHA512_rng_candidate<FieldT>(rval, (const mp_limb_t*)hash));
 
-        /* clear all bits higher than MSB of modulus */
-        size_t bitno = GMP_NUMB_BITS * FieldT::num_limbs - 1;
+    return FieldT(rval);
+}
 
-        /* mod is non-zero so the loop will always terminate */
-        while (FieldT::mod.test_bit(bitno) == false)
-        {
-            const std::size_t part = bitno/GMP_NUMB_BITS;
-            const std::size_t bit = bitno - (GMP_NUMB_BITS*part);
+template<typename FieldT>
+std::vector<FieldT> SHA512_rng_batch(const uint64_t start, const size_t count)
+{
+    assert(GMP_NUMB_BITS == 64);
+    assert(is_little_endian());
 
-            static const mp_limb_t one = 1;
-            rval.data[part] &= ~(one<<bit);
+    assert(FieldT::ceil_size_in_bits() <= 512);
 
-            bitno--;
+    std::vector<FieldT> result(count);
+
+    /*
+      Each chunk hashes all its indices with iter = 0, then keeps re-hashing
+      the rejected ones with the next iter, exactly as SHA512_rng would.
+     */
+    const size_t chunk_size = 1024;
+    const size_t num_chunks = (count + chunk_size - 1) / chunk_size;
+#ifdef MULTICORE
+#pragma omp parallel for
+#endif
+    for (size_t c = 0; c < num_chunks; ++c)
+    {
+        const size_t begin = c * chunk_size;
+        size_t pending = std::min(count, begin + chunk_size) - begin;
+
+        std::vector<size_t> pos(pending);
+        std::vector<uint64_t> idx(pending), iter(pending, 0);
+        std::vector<uint64_t> digests(8 * pending);
+        for (size_t j = 0; j < pending; ++j)
+        {
+            pos[j] = begin + j;
+            idx[j] = start + begin + j;
         }
 
-        ++iter;
+        while (pending != 0)
+        {
+            sha512_index_digests(&digests[0], &idx[0], &iter[0], pending);
+
+            size_t rejected = 0;
+            for (size_t j = 0; j < pending; ++j)
+            {
+                bigint<FieldT::num_limbs> rval;
+                if (SHA512_rng_candidate<FieldT>(rval, (const mp_limb_t*)&digests[8 * j]))
+                {
+                    result[pos[j]] = FieldT(rval);
+                }
+                else
+                {
+                    pos[rejected] = pos[j];
+                    idx[rejected] = idx[j];
+                    iter[rejected] = iter[j] + 1;
+                    ++rejected;
+                }
+            }
+            pending = rejected;
+        }
     }
 
-    /* if r.data is still >= modulus -- repeat (rejection sampling) */
-    while (mpn_cmp(rval.data, FieldT::mod.data, FieldT::num_limbs) >= 0);
-
-    return FieldT(rval);
+    return result;
 }
 
 } // namespace libff
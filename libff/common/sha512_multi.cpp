@@ -0,0 +1,203 @@
+/** @file
+ *****************************************************************************
+ Implementation of a multi-buffer SHA-512 for the short messages hashed by
+ SHA512_rng.
+
+ See sha512_multi.hpp .
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+#include <algorithm>
+#include <cstring>
+
+#include <libff/common/sha512_multi.hpp>
+#include <libff/common/utils.hpp>
+
+namespace libff {
+
+using std::size_t;
+
+namespace {
+
+const uint64_t sha512_k[80] = {
+    0x428a2f98d728ae22ull, 0x7137449123ef65cdull, 0xb5c0fbcfec4d3b2full, 0xe9b5dba58189dbbcull,
+    0x3956c25bf348b538ull, 0x59f111f1b605d019ull, 0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull,
+    0xd807aa98a3030242ull, 0x12835b0145706fbeull, 0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+    0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull, 0x9bdc06a725c71235ull, 0xc19bf174cf692694ull,
+    0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull, 0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull,
+    0x2de92c6f592b0275ull, 0x4a7484aa6ea6e483ull, 0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+    0x983e5152ee66dfabull, 0xa831c66d2db43210ull, 0xb00327c898fb213full, 0xbf597fc7beef0ee4ull,
+    0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull, 0x06ca6351e003826full, 0x142929670a0e6e70ull,
+    0x27b70a8546d22ffcull, 0x2e1b21385c26c926ull, 0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+    0x650a73548baf63deull, 0x766a0abb3c77b2a8ull, 0x81c2c92e47edaee6ull, 0x92722c851482353bull,
+    0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull, 0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull,
+    0xd192e819d6ef5218ull, 0xd69906245565a910ull, 0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+    0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull, 0x2748774cdf8eeb99ull, 0x34b0bcb5e19b48a8ull,
+    0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull, 0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull,
+    0x748f82ee5defb2fcull, 0x78a5636f43172f60ull, 0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+    0x90befffa23631e28ull, 0xa4506cebde82bde9ull, 0xbef9a3f7b2c67915ull, 0xc67178f2e372532bull,
+    0xca273eceea26619cull, 0xd186b8c721c0c207ull, 0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull,
+    0x06f067aa72176fbaull, 0x0a637dc5a2c898a6ull, 0x113f9804bef90daeull, 0x1b710b35131c471bull,
+    0x28db77f523047d84ull, 0x32caab7b40c72493ull, 0x3c9ebe0a15c9bebcull, 0x431d67c49c100d4cull,
+    0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull, 0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull };
+
+const uint64_t sha512_h0[8] = {
+    0x6a09e667f3bcc908ull, 0xbb67ae8584caa73bull, 0x3c6ef372fe94f82bull, 0xa54ff53a5f1d36f1ull,
+    0x510e527fade682d1ull, 0x9b05688c2b3e6c1full, 0x1f83d9abfb41bd6bull, 0x5be0cd19137e2179ull };
+
+#define SHA512_ROTR(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+/*
+  Hashes messages idx[0..lanes-1], iter[0..lanes-1] at once. V is either
+  uint64_t or a GCC vector of lanes 64-bit words, so the same code is the
+  scalar fallback and (inlined into the functions below, which enable the
+  extensions) the AVX2 and AVX-512 kernels.
+
+  A 16-byte message pads to the single block
+    W[0] = idx, W[1] = iter (both byte-swapped), W[2] = 0x80 << 56,
+    W[3..14] = 0, W[15] = 128 (the length in bits).
+ */
+template<typename V, size_t lanes>
+inline __attribute__((always_inline))
+void sha512_index_digests_lanes(uint64_t *digests, const uint64_t *idx, const uint64_t *iter)
+{
+    static_assert(sizeof(V) == lanes * sizeof(uint64_t), "V must hold one word per lane");
+
+    uint64_t words[lanes];
+    V w[16];
+    for (size_t l = 0; l < lanes; ++l)
+    {
+        words[l] = __builtin_bswap64(idx[l]);
+    }
+    std::memcpy(&w[0], words, sizeof(V));
+    for (size_t l = 0; l < lanes; ++l)
+    {
+        words[l] = __builtin_bswap64(iter[l]);
+    }
+    std::memcpy(&w[1], words, sizeof(V));
+
+    const V zero = V();
+    w[2] = zero + (uint64_t(1) << 63);
+    for (size_t t = 3; t < 15; ++t)
+    {
+        w[t] = zero;
+    }
+    w[15] = zero + uint64_t(128);
+
+    V a = zero + sha512_h0[0], b = zero + sha512_h0[1], c = zero + sha512_h0[2], d = zero + sha512_h0[3];
+    V e = zero + sha512_h0[4], f = zero + sha512_h0[5], g = zero + sha512_h0[6], h = zero + sha512_h0[7];
+
+    _Pragma("GCC unroll 80")
+    for (size_t t = 0; t < 80; ++t)
+    {
+        if (t >= 16)
+        {
+            const V w2 = w[(t - 2) & 15], w15 = w[(t - 15) & 15];
+            w[t & 15] += (SHA512_ROTR(w2, 19) ^ SHA512_ROTR(w2, 61) ^ (w2 >> 6)) + w[(t - 7) & 15]
+                + (SHA512_ROTR(w15, 1) ^ SHA512_ROTR(w15, 8) ^ (w15 >> 7));
+        }
+        const V t1 = h + (SHA512_ROTR(e, 14) ^ SHA512_ROTR(e, 18) ^ SHA512_ROTR(e, 41))
+            + ((e & f) ^ (~e & g)) + sha512_k[t] + w[t & 15];
+        const V t2 = (SHA512_ROTR(a, 28) ^ SHA512_ROTR(a, 34) ^ SHA512_ROTR(a, 39))
+            + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    const V state[8] = { a, b, c, d, e, f, g, h };
+    for (size_t k = 0; k < 8; ++k)
+    {
+        std::memcpy(words, &state[k], sizeof(V));
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            digests[8*l + k] = __builtin_bswap64(words[l] + sha512_h0[k]);
+        }
+    }
+}
+
+#undef SHA512_ROTR
+
+typedef void (*sha512_kernel)(uint64_t*, const uint64_t*, const uint64_t*);
+
+void sha512_index_digests_x1(uint64_t *digests, const uint64_t *idx, const uint64_t *iter)
+{
+    sha512_index_digests_lanes<uint64_t, 1>(digests, idx, iter);
+}
+
+#if defined(__x86_64__) && defined(USE_ASM)
+/* the library is not built with -mavx*, so enable the extensions per function */
+typedef uint64_t u64x4 __attribute__((vector_size(32)));
+typedef uint64_t u64x8 __attribute__((vector_size(64)));
+
+__attribute__((target("avx2")))
+void sha512_index_digests_x4(uint64_t *digests, const uint64_t *idx, const uint64_t *iter)
+{
+    sha512_index_digests_lanes<u64x4, 4>(digests, idx, iter);
+}
+
+__attribute__((target("avx512f")))
+void sha512_index_digests_x8(uint64_t *digests, const uint64_t *idx, const uint64_t *iter)
+{
+    sha512_index_digests_lanes<u64x8, 8>(digests, idx, iter);
+}
+#endif
+
+size_t default_sha512_lanes()
+{
+#if defined(__x86_64__) && defined(USE_ASM)
+    if (cpu_supports_avx512f())
+    {
+        return 8;
+    }
+    if (cpu_supports_avx2())
+    {
+        return 4;
+    }
+#endif
+    return 1;
+}
+
+} // namespace
+
+size_t sha512_multi_lanes = default_sha512_lanes();
+
+void sha512_index_digests(uint64_t *digests, const uint64_t *idx, const uint64_t *iter, const size_t count)
+{
+    size_t lanes = 1;
+    sha512_kernel kernel = sha512_index_digests_x1;
+#if defined(__x86_64__) && defined(USE_ASM)
+    if (sha512_multi_lanes >= 8)
+    {
+        lanes = 8;
+        kernel = sha512_index_digests_x8;
+    }
+    else if (sha512_multi_lanes >= 4)
+    {
+        lanes = 4;
+        kernel = sha512_index_digests_x4;
+    }
+#endif
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes)
+    {
+        kernel(digests + 8*i, idx + i, iter + i);
+    }
+    if (i < count)
+    {
+        /* pad the last group by repeating its final message */
+        uint64_t tail_idx[8], tail_iter[8], tail_digests[8 * 8];
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            const size_t j = std::min(i + l, count - 1);
+            tail_idx[l] = idx[j];
+            tail_iter[l] = iter[j];
+        }
+        kernel(tail_digests, tail_idx, tail_iter);
+        std::memcpy(digests + 8*i, tail_digests, 8 * (count - i) * sizeof(uint64_t));
+    }
+}
+
+} // namespace libff
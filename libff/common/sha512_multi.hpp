@@ -0,0 +1,40 @@
+/** @file
+ *****************************************************************************
+ Declaration of a multi-buffer SHA-512 for the short messages hashed by
+ SHA512_rng.
+ *****************************************************************************
+ * @author     This file is part of libff, developed by SCIPR Lab
+ *             and contributors (see AUTHORS).
+ * @copyright  MIT license (see LICENSE file)
+ *****************************************************************************/
+#ifndef SHA512_MULTI_HPP_
+#define SHA512_MULTI_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libff {
+
+/**
+ * Computes SHA-512 of count 16-byte messages, message i being idx[i]
+ * followed by iter[i], each as 8 little-endian bytes. Word k of digest i,
+ * digests[8*i+k], holds digest bytes 8*k .. 8*k+7 read as a little-endian
+ * word: on a little-endian host the digests are laid out exactly as
+ * SHA512_Final would write them.
+ *
+ * Every message fits in a single SHA-512 block, so the compression runs
+ * sha512_multi_lanes messages at a time in SIMD registers.
+ */
+void sha512_index_digests(uint64_t *digests, const uint64_t *idx, const uint64_t *iter, const std::size_t count);
+
+/**
+ * Number of messages sha512_index_digests hashes at once: 8 with AVX-512F,
+ * 4 with AVX2 and 1 otherwise (or when not compiled with USE_ASM on
+ * x86-64). Initialized at startup from cpu_supports_avx512f() and
+ * cpu_supports_avx2(); lower it to force a narrower kernel.
+ */
+extern std::size_t sha512_multi_lanes;
+
+} // namespace libff
+
+#endif // SHA512_MULTI_HPP_
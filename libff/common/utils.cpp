@@ -10,6 +10,9 @@
 #include <cassert>
 #include <cstdarg>
 #include <cstdint>
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
 
 #include <libff/common/utils.hpp>
 
@@ -103,6 +106,94 @@ bool is_little_endian()
     return (*c == 0x78);
 }
 
+bool cpu_supports_mulx_adx()
+{
+#if defined(__x86_64__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    const unsigned int bmi2 = 1u << 8, adx = 1u << 19; // CPUID.(EAX=07H, ECX=0):EBX
+    return (ebx & bmi2) && (ebx & adx);
+#else
+    return false;
+#endif
+}
+
+bool use_mulx_adx = cpu_supports_mulx_adx();
+
+#if defined(__x86_64__)
+/* true if the OS saves all the register state in mask, as reported by XGETBV */
+static bool os_saves_xstate(const unsigned int mask)
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    const unsigned int osxsave = 1u << 27; // CPUID.(EAX=01H):ECX
+    if (!(ecx & osxsave))
+    {
+        return false;
+    }
+    unsigned int xcr0_lo, xcr0_hi;
+    __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+    UNUSED(xcr0_hi);
+    return (xcr0_lo & mask) == mask;
+}
+
+static const unsigned int ymm_state = 0x06; // XCR0: SSE and AVX state
+static const unsigned int zmm_state = 0xe6; // XCR0: SSE, AVX, opmask, ZMM_Hi256 and Hi16_ZMM state
+#endif
+
+bool cpu_supports_avx2()
+{
+#if defined(__x86_64__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!os_saves_xstate(ymm_state) || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    const unsigned int avx2 = 1u << 5; // CPUID.(EAX=07H, ECX=0):EBX
+    return (ebx & avx2);
+#else
+    return false;
+#endif
+}
+
+bool cpu_supports_avx512f()
+{
+#if defined(__x86_64__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!os_saves_xstate(zmm_state) || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    const unsigned int avx512f = 1u << 16; // CPUID.(EAX=07H, ECX=0):EBX
+    return (ebx & avx512f);
+#else
+    return false;
+#endif
+}
+
+bool cpu_supports_avx512_ifma()
+{
+#if defined(__x86_64__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!os_saves_xstate(zmm_state) || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+    const unsigned int avx512f = 1u << 16, avx512ifma = 1u << 21; // CPUID.(EAX=07H, ECX=0):EBX
+    return (ebx & avx512f) && (ebx & avx512ifma);
+#else
+    return false;
+#endif
+}
+
+bool use_avx512_ifma = cpu_supports_avx512_ifma();
+
 std::string FORMAT(const std::string &prefix, const char* format, ...)
 {
     const static size_t MAX_FMT = 256;
@@ -36,6 +36,45 @@ long long div_ceil(long long x, long long y);
 
 bool is_little_endian();
 
+/**
+ * Returns true if the CPU supports the BMI2 (mulx) and ADX (adcx/adox)
+ * instruction set extensions, as reported by CPUID.
+ */
+bool cpu_supports_mulx_adx();
+
+/**
+ * If set (and compiled with USE_ASM), Fp_model uses the mulx/adcx/adox
+ * assembly for Montgomery multiplication of 4, 5 and 6 limbs. Initialized
+ * at startup from cpu_supports_mulx_adx(); clear it to force the plain
+ * mul/adc code path.
+ */
+extern bool use_mulx_adx;
+
+/**
+ * Returns true if the CPU supports AVX2, and the OS saves the 256-bit
+ * register state, as reported by CPUID and XGETBV.
+ */
+bool cpu_supports_avx2();
+
+/**
+ * Returns true if the CPU supports AVX-512F, and the OS saves the 512-bit
+ * register state, as reported by CPUID and XGETBV.
+ */
+bool cpu_supports_avx512f();
+
+/**
+ * Returns true if the CPU supports AVX-512F and AVX-512 IFMA, and the OS
+ * saves the 512-bit register state, as reported by CPUID and XGETBV.
+ */
+bool cpu_supports_avx512_ifma();
+
+/**
+ * If set (and compiled with USE_ASM), the Fp_model vector functions
+ * (batch_mul etc.) use AVX-512 IFMA kernels for 4-limb fields. Initialized
+ * at startup from cpu_supports_avx512_ifma().
+ */
+extern bool use_avx512_ifma;
+
 std::string FORMAT(const std::string &prefix, const char* format, ...);
 
 /* A variadic template to suppress unused argument warnings */